@@ -0,0 +1,38 @@
+package com.glion.ndk_essentia_test.embedding
+
+import android.content.Context
+import androidx.test.core.app.ApplicationProvider
+import org.junit.After
+import java.io.File
+import java.io.FileOutputStream
+
+/**
+ * Project : Resonance
+ * File : AssetFixtures
+ * Created by glion on 2025-12-21
+ *
+ * Description:
+ * - JNI 테스트 공용 픽스처. 에셋을 캐시저장소로 복사하고, 테스트 종료 시 캐시저장소를 정리
+ *
+ * Copyright @2025 Gangglion. All rights reserved
+ */
+abstract class AssetFixtures {
+
+    @After
+    fun teardown() {
+        // 캐시저장소 정리
+        val context = ApplicationProvider.getApplicationContext<Context>()
+        context.cacheDir.deleteRecursively()
+    }
+
+    // fileName 을 지정하면 같은 에셋을 다른 이름으로 여러 번 복사할 수 있음
+    protected fun copyAssetToCache(context: Context, assetName: String, fileName: String = assetName): File {
+        val cacheFile = File(context.cacheDir, fileName)
+        context.assets.open(assetName).use { input ->
+            FileOutputStream(cacheFile).use { output ->
+                input.copyTo(output)
+            }
+        }
+        return cacheFile
+    }
+}
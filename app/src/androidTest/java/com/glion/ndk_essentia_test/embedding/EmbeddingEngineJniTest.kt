@@ -0,0 +1,50 @@
+package com.glion.ndk_essentia_test.embedding
+
+import android.content.Context
+import android.util.Log
+import androidx.test.core.app.ApplicationProvider
+import com.glion.ndk_essentia_test.InferenceJniBridge
+import kotlinx.coroutines.test.runTest
+import org.junit.Assert.assertArrayEquals
+import org.junit.Assert.assertTrue
+import org.junit.Test
+
+/**
+ * Project : Resonance
+ * File : EmbeddingEngineJniTest
+ * Created by glion on 2025-12-01
+ *
+ * Description:
+ * - JNI 엔진 핸들(createEngine / embedWithEngine / destroyEngine)을 통한 임베딩 테스트
+ *
+ * Copyright @2025 Gangglion. All rights reserved
+ */
+class EmbeddingEngineJniTest : AssetFixtures() {
+
+    @Test
+    fun engine_embedTwice_sameEmbedding() = runTest {
+        val context = ApplicationProvider.getApplicationContext<Context>()
+        val audioPath = copyAssetToCache(context, "sample.mp3").absolutePath
+        val modelPath = copyAssetToCache(context, "model.onnx").absolutePath
+        copyAssetToCache(context, "model.onnx.data")
+
+        val jniBridge = InferenceJniBridge()
+        val handle = jniBridge.createEngine(modelPath)
+        try {
+            // 첫 호출 (엔진 생성 이후)
+            var startTime = System.currentTimeMillis()
+            val first = jniBridge.embedWithEngine(handle, audioPath)!!
+            Log.i("glion", "엔진 첫 번째 임베딩 소요시간 :: ${System.currentTimeMillis() - startTime} ms")
+
+            // 두 번째 호출 - 모델 재로드 없이 동일 결과여야 함
+            startTime = System.currentTimeMillis()
+            val second = jniBridge.embedWithEngine(handle, audioPath)!!
+            Log.i("glion", "엔진 두 번째 임베딩 소요시간 :: ${System.currentTimeMillis() - startTime} ms")
+
+            assertTrue(first.isNotEmpty())
+            assertArrayEquals(first, second, 1e-6f)
+        } finally {
+            jniBridge.destroyEngine(handle)
+        }
+    }
+}
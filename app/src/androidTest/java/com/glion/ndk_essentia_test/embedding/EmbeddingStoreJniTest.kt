@@ -0,0 +1,132 @@
+package com.glion.ndk_essentia_test.embedding
+
+import android.content.Context
+import android.util.Log
+import androidx.test.core.app.ApplicationProvider
+import com.glion.ndk_essentia_test.InferenceJniBridge
+import kotlinx.coroutines.test.runTest
+import org.junit.Assert.assertArrayEquals
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertTrue
+import org.junit.Test
+import java.io.File
+import java.io.RandomAccessFile
+
+/**
+ * Project : Resonance
+ * File : EmbeddingStoreJniTest
+ * Created by glion on 2025-12-17
+ *
+ * Description:
+ * - allInferencePipeline 의 두 번째 호출이 기본 저장소(<모델 경로>.store)에 적중하여 모델 로드 없이 같은 임베딩을 반환하는지 확인
+ * - 저장소를 사용하는 엔진에서 같은 곡의 두 번째 embed 가 저장소에 적중하여 같은 임베딩을 반환하는지 확인
+ * - 저장소 파일이 엔진 사이에 유지되는지, 저장소를 켜지 않은 엔진은 적중하지 않는지 확인
+ * - 크기는 같고 중간 바이트만 바뀐 파일은 적중하지 않는지 확인 (내용 키는 파일 전체 해시)
+ *
+ * Copyright @2025 Gangglion. All rights reserved
+ */
+class EmbeddingStoreJniTest : AssetFixtures() {
+
+    @Test
+    fun allInferencePipeline_secondCallHitsStore() = runTest {
+        val context = ApplicationProvider.getApplicationContext<Context>()
+        val audioPath = copyAssetToCache(context, "sample.mp3").absolutePath
+        val modelPath = copyAssetToCache(context, "model.onnx").absolutePath
+        copyAssetToCache(context, "model.onnx.data")
+        val storeFile = File("$modelPath.store")
+
+        val jniBridge = InferenceJniBridge()
+
+        var startTime = System.nanoTime()
+        val first = jniBridge.allInferencePipeline(audioPath, modelPath)!!
+        Log.i("glion", "저장소 미적중 소요시간 :: ${(System.nanoTime() - startTime) / 1_000_000.0} ms")
+        assertTrue(storeFile.exists())
+        val storeSize = storeFile.length()
+
+        startTime = System.nanoTime()
+        val second = jniBridge.allInferencePipeline(audioPath, modelPath)!!
+        Log.i("glion", "저장소 적중 소요시간 :: ${(System.nanoTime() - startTime) / 1_000_000.0} ms")
+
+        // 미적중이면 파이프라인 결과를 다시 덧붙이므로 저장소 크기가 그대로면 적중
+        assertEquals(storeSize, storeFile.length())
+        assertArrayEquals(first, second, 0f)
+    }
+
+    @Test
+    fun embedWithEngine_secondCallHitsStore() = runTest {
+        val context = ApplicationProvider.getApplicationContext<Context>()
+        val audioPath = copyAssetToCache(context, "sample.mp3").absolutePath
+        val modelPath = copyAssetToCache(context, "model.onnx").absolutePath
+        copyAssetToCache(context, "model.onnx.data")
+        val storeFile = File(context.cacheDir, "embeddings.store")
+
+        val jniBridge = InferenceJniBridge()
+
+        // 1. 저장소 미적중 -> 전체 파이프라인 수행 후 레코드 추가 (파일 내용 키 + 디코딩 지문 키), 2. 같은 엔진에서 적중
+        var handle = jniBridge.createEngineWithStore(modelPath, storeFile.absolutePath)
+        val first: FloatArray
+        try {
+            var startTime = System.nanoTime()
+            first = jniBridge.embedWithEngine(handle, audioPath)!!
+            Log.i("glion", "저장소 미적중 소요시간 :: ${(System.nanoTime() - startTime) / 1_000_000.0} ms")
+            assertArrayEquals(longArrayOf(0, 0, 0, 2), jniBridge.getCacheStats(handle))
+
+            startTime = System.nanoTime()
+            val second = jniBridge.embedWithEngine(handle, audioPath)!!
+            Log.i("glion", "저장소 적중 소요시간 :: ${(System.nanoTime() - startTime) / 1_000_000.0} ms")
+            assertArrayEquals(longArrayOf(1, 0, 0, 2), jniBridge.getCacheStats(handle))
+            assertArrayEquals(first, second, 0f)
+        } finally {
+            jniBridge.destroyEngine(handle)
+        }
+
+        // 3. 새 엔진에서도 파일에 저장된 레코드로 적중
+        handle = jniBridge.createEngineWithStore(modelPath, storeFile.absolutePath)
+        try {
+            val reopened = jniBridge.embedWithEngine(handle, audioPath)!!
+            assertArrayEquals(longArrayOf(1, 0, 0, 2), jniBridge.getCacheStats(handle))
+            assertArrayEquals(first, reopened, 0f)
+        } finally {
+            jniBridge.destroyEngine(handle)
+        }
+
+        // 4. 저장소를 켜지 않은 엔진은 저장소를 조회하지 않음
+        handle = jniBridge.createEngine(modelPath)
+        try {
+            jniBridge.embedWithEngine(handle, audioPath)!!
+            assertArrayEquals(longArrayOf(0, 0, 0, 0), jniBridge.getCacheStats(handle))
+        } finally {
+            jniBridge.destroyEngine(handle)
+        }
+    }
+
+    @Test
+    fun embedWithEngine_sameSizeEditMissesStore() = runTest {
+        val context = ApplicationProvider.getApplicationContext<Context>()
+        val audioFile = copyAssetToCache(context, "sample.mp3")
+        val modelPath = copyAssetToCache(context, "model.onnx").absolutePath
+        copyAssetToCache(context, "model.onnx.data")
+
+        val jniBridge = InferenceJniBridge()
+        val handle = jniBridge.createEngineWithStore(modelPath, "")
+        try {
+            jniBridge.embedWithEngine(handle, audioFile.absolutePath)!!
+            assertArrayEquals(longArrayOf(0, 0, 0, 2), jniBridge.getCacheStats(handle))
+
+            // 파일 중간 1바이트만 변경 (크기 동일, 수정 시각 갱신)
+            RandomAccessFile(audioFile, "rw").use { file ->
+                val position = file.length() / 2
+                file.seek(position)
+                val value = file.read()
+                file.seek(position)
+                file.write(value xor 0x01)
+            }
+
+            jniBridge.embedWithEngine(handle, audioFile.absolutePath)!!
+            // 내용 키 / 지문 키 모두 미적중 -> 전체 파이프라인 수행 후 레코드 2개 추가
+            assertArrayEquals(longArrayOf(0, 0, 0, 4), jniBridge.getCacheStats(handle))
+        } finally {
+            jniBridge.destroyEngine(handle)
+        }
+    }
+}
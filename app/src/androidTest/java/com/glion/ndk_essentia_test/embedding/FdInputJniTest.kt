@@ -0,0 +1,64 @@
+package com.glion.ndk_essentia_test.embedding
+
+import android.content.Context
+import android.util.Log
+import androidx.test.core.app.ApplicationProvider
+import com.glion.ndk_essentia_test.InferenceJniBridge
+import kotlinx.coroutines.test.runTest
+import org.junit.Assert.assertArrayEquals
+import org.junit.Test
+import java.nio.ByteBuffer
+
+/**
+ * Project : Resonance
+ * File : FdInputJniTest
+ * Created by glion on 2025-12-21
+ *
+ * Description:
+ * - APK 에셋 fd 구간(AssetFileDescriptor) / direct ByteBuffer 입력이 임시 파일 복사 없이 경로 입력과 같은 임베딩을 반환하는지 확인
+ *
+ * Copyright @2025 Gangglion. All rights reserved
+ */
+class FdInputJniTest : AssetFixtures() {
+
+    // 1회 임베딩 소요시간 기록 (createEngine 엔진은 저장소를 사용하지 않으므로 매번 실제 디코딩 / 추론 수행)
+    private fun timed(label: String, block: () -> FloatArray?): FloatArray {
+        val startTime = System.nanoTime()
+        val embedding = block()!!
+        Log.i("glion", "$label 소요시간 :: ${(System.nanoTime() - startTime) / 1_000_000.0} ms")
+        return embedding
+    }
+
+    @Test
+    fun embedWithEngine_fdAndBufferMatchPath() = runTest {
+        val context = ApplicationProvider.getApplicationContext<Context>()
+        val audioPath = copyAssetToCache(context, "sample.mp3").absolutePath
+        val modelPath = copyAssetToCache(context, "model.onnx").absolutePath
+        copyAssetToCache(context, "model.onnx.data")
+
+        val jniBridge = InferenceJniBridge()
+        val handle = jniBridge.createEngine(modelPath)
+        try {
+            val fromPath = timed("경로 입력") {
+                jniBridge.embedWithEngine(handle, audioPath)
+            }
+
+            val fromFd = timed("에셋 fd 입력") {
+                context.assets.openFd("sample.mp3").use { afd ->
+                    jniBridge.embedWithEngineFd(handle, afd.parcelFileDescriptor.fd, afd.startOffset, afd.length)
+                }
+            }
+
+            val bytes = context.assets.open("sample.mp3").use { it.readBytes() }
+            val buffer = ByteBuffer.allocateDirect(bytes.size).put(bytes)
+            val fromBuffer = timed("메모리 입력") {
+                jniBridge.embedWithEngineBuffer(handle, buffer, 0, bytes.size)
+            }
+
+            assertArrayEquals(fromPath, fromFd, 0f)
+            assertArrayEquals(fromPath, fromBuffer, 0f)
+        } finally {
+            jniBridge.destroyEngine(handle)
+        }
+    }
+}
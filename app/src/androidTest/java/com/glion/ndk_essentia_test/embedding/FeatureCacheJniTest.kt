@@ -0,0 +1,67 @@
+package com.glion.ndk_essentia_test.embedding
+
+import android.content.Context
+import android.util.Log
+import androidx.test.core.app.ApplicationProvider
+import com.glion.ndk_essentia_test.InferenceJniBridge
+import kotlinx.coroutines.test.runTest
+import org.junit.Assert.assertArrayEquals
+import org.junit.Assert.assertEquals
+import org.junit.Test
+import java.io.File
+
+/**
+ * Project : Resonance
+ * File : FeatureCacheJniTest
+ * Created by glion on 2025-12-18
+ *
+ * Description:
+ * - 특징 캐시 적중 시 디코딩 / 특징 추출 없이 같은 임베딩을 반환하는지 확인
+ * - 엔진을 새로 만들어 모델이 바뀐 상황(저장소 없음, 특징 캐시 적중)을 재현
+ *
+ * Copyright @2025 Gangglion. All rights reserved
+ */
+class FeatureCacheJniTest : AssetFixtures() {
+
+    // 새 엔진으로 1회 임베딩. 반환: (임베딩, 특징 캐시 적중 횟수)
+    private fun embedOnce(jniBridge: InferenceJniBridge, modelPath: String, cacheDir: File, audioPath: String, halfPrecision: Boolean): Pair<FloatArray, Long> {
+        val handle = jniBridge.createEngineWithFeatureCache(modelPath, cacheDir.absolutePath, halfPrecision)
+        try {
+            val startTime = System.nanoTime()
+            val embedding = jniBridge.embedWithEngine(handle, audioPath)!!
+            Log.i("glion", "특징 캐시 (fp16=$halfPrecision) 소요시간 :: ${(System.nanoTime() - startTime) / 1_000_000.0} ms")
+            return embedding to jniBridge.getCacheStats(handle)!![2]
+        } finally {
+            jniBridge.destroyEngine(handle)
+        }
+    }
+
+    private fun runFeatureCache(halfPrecision: Boolean, tolerance: Float) {
+        val context = ApplicationProvider.getApplicationContext<Context>()
+        val audioPath = copyAssetToCache(context, "sample.mp3").absolutePath
+        val modelPath = copyAssetToCache(context, "model.onnx").absolutePath
+        copyAssetToCache(context, "model.onnx.data")
+        val cacheDir = File(context.cacheDir, "features")
+
+        val jniBridge = InferenceJniBridge()
+
+        val (first, missHits) = embedOnce(jniBridge, modelPath, cacheDir, audioPath, halfPrecision)
+        assertEquals(0L, missHits)
+        assertEquals(1, cacheDir.listFiles { file -> file.name.endsWith(".feat") }?.size ?: 0)
+
+        val (second, hits) = embedOnce(jniBridge, modelPath, cacheDir, audioPath, halfPrecision)
+        assertEquals(1L, hits)
+
+        assertArrayEquals(first, second, tolerance)
+    }
+
+    @Test
+    fun featureCache_float32_skipsDecodeAndFeatures() = runTest {
+        runFeatureCache(halfPrecision = false, tolerance = 1e-5f)
+    }
+
+    @Test
+    fun featureCache_float16_matchesWithinTolerance() = runTest {
+        runFeatureCache(halfPrecision = true, tolerance = 1e-2f)
+    }
+}
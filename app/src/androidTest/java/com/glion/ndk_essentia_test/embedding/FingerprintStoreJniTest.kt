@@ -0,0 +1,101 @@
+package com.glion.ndk_essentia_test.embedding
+
+import android.content.Context
+import android.util.Log
+import androidx.test.core.app.ApplicationProvider
+import com.glion.ndk_essentia_test.InferenceJniBridge
+import kotlinx.coroutines.test.runTest
+import org.junit.Assert.assertArrayEquals
+import org.junit.Test
+import java.io.File
+import java.io.FileOutputStream
+
+/**
+ * Project : Resonance
+ * File : FingerprintStoreJniTest
+ * Created by glion on 2025-12-20
+ *
+ * Description:
+ * - 태그만 다른 같은 곡(파일 내용 해시 불일치)이 디코딩 지문으로 저장소에 적중하여 특징 추출 / 추론 없이 같은 임베딩을 반환하는지 확인
+ * - 앞부분 패킷이 같은 잘린 복사본(중단된 다운로드 등)은 지문에 적중하지 않는지 확인
+ *
+ * Copyright @2025 Gangglion. All rights reserved
+ */
+class FingerprintStoreJniTest : AssetFixtures() {
+
+    // 원본 앞에 빈 ID3v2 태그(패딩 1KB)를 붙인 복사본 - 오디오 스트림 패킷은 그대로, 파일 바이트는 다름
+    private fun writeRetaggedCopy(source: File, target: File): File {
+        val paddingSize = 1024
+        val header = byteArrayOf(
+            'I'.code.toByte(), 'D'.code.toByte(), '3'.code.toByte(), 4, 0, 0,
+            0, 0, (paddingSize shr 7).toByte(), (paddingSize and 0x7F).toByte()
+        )
+        FileOutputStream(target).use { output ->
+            output.write(header)
+            output.write(ByteArray(paddingSize))
+            source.inputStream().use { it.copyTo(output) }
+        }
+        return target
+    }
+
+    // 원본 앞 3/4 바이트만 남긴 복사본 - 앞부분 패킷은 원본과 같고 뒤쪽 패킷이 없음
+    private fun writeTruncatedCopy(source: File, target: File): File {
+        val bytes = source.readBytes()
+        FileOutputStream(target).use { output ->
+            output.write(bytes, 0, bytes.size * 3 / 4)
+        }
+        return target
+    }
+
+    @Test
+    fun embedWithEngine_retaggedCopyHitsFingerprint() = runTest {
+        val context = ApplicationProvider.getApplicationContext<Context>()
+        val original = copyAssetToCache(context, "sample.mp3")
+        val retagged = writeRetaggedCopy(original, File(context.cacheDir, "sample_retagged.mp3"))
+        val modelPath = copyAssetToCache(context, "model.onnx").absolutePath
+        copyAssetToCache(context, "model.onnx.data")
+
+        val jniBridge = InferenceJniBridge()
+        val handle = jniBridge.createEngineWithStore(modelPath, "")
+        try {
+            var startTime = System.nanoTime()
+            val first = jniBridge.embedWithEngine(handle, original.absolutePath)!!
+            Log.i("glion", "원본 (저장소 미적중) 소요시간 :: ${(System.nanoTime() - startTime) / 1_000_000.0} ms")
+            // 미적중 - 파일 내용 키 + 지문 키 레코드 2개
+            assertArrayEquals(longArrayOf(0, 0, 0, 2), jniBridge.getCacheStats(handle))
+
+            startTime = System.nanoTime()
+            val second = jniBridge.embedWithEngine(handle, retagged.absolutePath)!!
+            Log.i("glion", "태그 변경 복사본 (지문 적중) 소요시간 :: ${(System.nanoTime() - startTime) / 1_000_000.0} ms")
+            // 파일 내용 키는 미적중, 지문 키 적중 (추론 결과가 아니라 저장된 임베딩 반환). 복사본의 내용 키 레코드 추가
+            assertArrayEquals(longArrayOf(0, 1, 0, 3), jniBridge.getCacheStats(handle))
+            assertArrayEquals(first, second, 0f)
+        } finally {
+            jniBridge.destroyEngine(handle)
+        }
+    }
+
+    @Test
+    fun embedWithEngine_truncatedCopyMissesFingerprint() = runTest {
+        val context = ApplicationProvider.getApplicationContext<Context>()
+        val original = copyAssetToCache(context, "sample.mp3")
+        val truncated = writeTruncatedCopy(original, File(context.cacheDir, "sample_truncated.mp3"))
+        val modelPath = copyAssetToCache(context, "model.onnx").absolutePath
+        copyAssetToCache(context, "model.onnx.data")
+
+        val jniBridge = InferenceJniBridge()
+        val handle = jniBridge.createEngineWithStore(modelPath, "")
+        try {
+            jniBridge.embedWithEngine(handle, original.absolutePath)!!
+            assertArrayEquals(longArrayOf(0, 0, 0, 2), jniBridge.getCacheStats(handle))
+
+            val startTime = System.nanoTime()
+            jniBridge.embedWithEngine(handle, truncated.absolutePath)!!
+            Log.i("glion", "잘린 복사본 (지문 미적중) 소요시간 :: ${(System.nanoTime() - startTime) / 1_000_000.0} ms")
+            // 파일 내용 키 / 지문 키 모두 미적중 -> 전체 파이프라인 수행 후 복사본의 레코드 2개 추가
+            assertArrayEquals(longArrayOf(0, 0, 0, 4), jniBridge.getCacheStats(handle))
+        } finally {
+            jniBridge.destroyEngine(handle)
+        }
+    }
+}
@@ -0,0 +1,63 @@
+package com.glion.ndk_essentia_test.embedding
+
+import android.content.Context
+import android.util.Log
+import androidx.test.core.app.ApplicationProvider
+import com.glion.ndk_essentia_test.InferenceJniBridge
+import kotlinx.coroutines.test.runTest
+import org.junit.Assert.assertArrayEquals
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertNotNull
+import org.junit.Assert.assertNull
+import org.junit.Test
+import java.io.File
+
+/**
+ * Project : Resonance
+ * File : IndexLibraryJniTest
+ * Created by glion on 2025-12-16
+ *
+ * Description:
+ * - 일괄 인덱싱(indexLibrary) 결과가 곡 단위 임베딩(embedWithEngine)과 같은지, 실패 곡이 콜백으로 보고되는지 확인
+ *
+ * Copyright @2025 Gangglion. All rights reserved
+ */
+class IndexLibraryJniTest : AssetFixtures() {
+
+    @Test
+    fun indexLibrary_matchesSingleEmbedding() = runTest {
+        val context = ApplicationProvider.getApplicationContext<Context>()
+        val modelPath = copyAssetToCache(context, "model.onnx").absolutePath
+        copyAssetToCache(context, "model.onnx.data")
+
+        // 같은 곡 4개 + 존재하지 않는 파일 1개
+        val paths = (0 until 4).map { copyAssetToCache(context, "sample.mp3", "sample_$it.mp3").absolutePath } +
+                File(context.cacheDir, "missing.mp3").absolutePath
+
+        val jniBridge = InferenceJniBridge()
+        val handle = jniBridge.createEngine(modelPath)
+        try {
+            val expected = jniBridge.embedWithEngine(handle, paths[0])!!
+
+            val embeddings = arrayOfNulls<FloatArray>(paths.size)
+            val errors = arrayOfNulls<String>(paths.size)
+            val startTime = System.currentTimeMillis()
+            val succeeded = jniBridge.indexLibrary(handle, paths.toTypedArray()) { index, _, embedding, error ->
+                embeddings[index] = embedding
+                errors[index] = error
+            }
+            Log.i("glion", "일괄 인덱싱 ${paths.size} 곡 소요시간 :: ${System.currentTimeMillis() - startTime} ms")
+
+            assertEquals(4, succeeded)
+            for (i in 0 until 4) {
+                assertNull(errors[i])
+                // 배치 크기에 따른 커널 차이만 허용
+                assertArrayEquals(expected, embeddings[i], 1e-4f)
+            }
+            assertNull(embeddings[4])
+            assertNotNull(errors[4])
+        } finally {
+            jniBridge.destroyEngine(handle)
+        }
+    }
+}
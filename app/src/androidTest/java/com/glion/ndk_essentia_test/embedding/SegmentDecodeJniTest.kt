@@ -0,0 +1,57 @@
+package com.glion.ndk_essentia_test.embedding
+
+import android.content.Context
+import android.util.Log
+import androidx.test.core.app.ApplicationProvider
+import com.glion.ndk_essentia_test.InferenceJniBridge
+import kotlinx.coroutines.test.runTest
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertTrue
+import org.junit.Test
+
+/**
+ * Project : Resonance
+ * File : SegmentDecodeJniTest
+ * Created by glion on 2025-12-23
+ *
+ * Description:
+ * - 구간 디코딩(segment_only_decode) 세그먼트가 전체 디코딩 + segmenter 세그먼트와 샘플 단위로 같은지 검증
+ * - sample.m4a 는 sample.mp3 를 AAC 로 인코딩한 에셋 (예: ffmpeg -i sample.mp3 -c:a aac sample.m4a)
+ *   인코더 priming 샘플과 이를 잘라내는 edit list 를 포함하므로 seek 후 타임라인 정렬을 함께 검증
+ *
+ * Copyright @2025 Gangglion. All rights reserved
+ */
+class SegmentDecodeJniTest : AssetFixtures() {
+
+    @Test
+    fun compareSegmentDecode_mp3MatchesFullDecode() = runTest {
+        assertPlannedMatchesFull("sample.mp3")
+    }
+
+    @Test
+    fun compareSegmentDecode_m4aMatchesFullDecode() = runTest {
+        assertPlannedMatchesFull("sample.m4a")
+    }
+
+    private fun assertPlannedMatchesFull(assetName: String) {
+        val context = ApplicationProvider.getApplicationContext<Context>()
+        val audioPath = copyAssetToCache(context, assetName).absolutePath
+
+        val result = InferenceJniBridge().compareSegmentDecode(audioPath)!!
+        val planned = result[0]
+        val plannedSegments = result[1]
+        val fullSegments = result[2]
+        val comparedSamples = result[3]
+        val mismatchedSamples = result[4]
+        val maxAbsDiff = result[5]
+        Log.i("glion", "$assetName segments :: planned $plannedSegments / full $fullSegments, " +
+                "samples :: $comparedSamples (mismatched $mismatchedSamples), maxAbsDiff :: $maxAbsDiff")
+
+        // 구간 디코딩 계획이 거절되면 전체 디코딩으로 대체되어 비교가 의미 없으므로 실패로 처리
+        assertEquals("segment plan declined for $assetName", 1f, planned, 0f)
+        assertEquals(fullSegments, plannedSegments, 0f)
+        assertTrue(comparedSamples > 0f)
+        // 세그먼트 길이와 모든 샘플이 같아야 함 (pre-roll / 리샘플러 위상이 어긋나면 큰 차이로 나타남)
+        assertEquals(0f, mismatchedSamples, 0f)
+    }
+}
@@ -0,0 +1,37 @@
+package com.glion.ndk_essentia_test.embedding
+
+import android.content.Context
+import android.util.Log
+import androidx.test.core.app.ApplicationProvider
+import com.glion.ndk_essentia_test.InferenceJniBridge
+import kotlinx.coroutines.test.runTest
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertTrue
+import org.junit.Test
+
+/**
+ * Project : Resonance
+ * File : StftBenchmarkJniTest
+ * Created by glion on 2025-12-08
+ *
+ * Description:
+ * - 기존 Essentia STFT 체인과 StftEngine 의 소요시간 / 결과 비교 (18.6초 세그먼트 1개)
+ *
+ * Copyright @2025 Gangglion. All rights reserved
+ */
+class StftBenchmarkJniTest : AssetFixtures() {
+
+    @Test
+    fun benchmarkStft_fusedMatchesLegacy() = runTest {
+        val context = ApplicationProvider.getApplicationContext<Context>()
+        val audioPath = copyAssetToCache(context, "sample.mp3").absolutePath
+
+        val result = InferenceJniBridge().benchmarkStft(audioPath)!!
+        val (legacyMs, fusedMs, legacyFrames, fusedFrames, maxRelDiff) = result.toList()
+        Log.i("glion", "STFT legacy :: $legacyMs ms, fused :: $fusedMs ms (x${legacyMs / fusedMs}), maxRelDiff :: $maxRelDiff")
+
+        // 프레임 수는 동일, 파워 스펙트럼은 float 연산 오차 수준
+        assertEquals(legacyFrames, fusedFrames, 0f)
+        assertTrue(maxRelDiff < 1e-3f)
+    }
+}
@@ -0,0 +1,35 @@
+package com.glion.ndk_essentia_test.embedding
+
+import android.content.Context
+import android.util.Log
+import androidx.test.core.app.ApplicationProvider
+import com.glion.ndk_essentia_test.InferenceJniBridge
+import kotlinx.coroutines.test.runTest
+import org.junit.Assert.assertTrue
+import org.junit.Test
+
+/**
+ * Project : Resonance
+ * File : TempogramBenchmarkJniTest
+ * Created by glion on 2025-12-09
+ *
+ * Description:
+ * - 기존 2D 템포그램 평균(FrameCutter + AutoCorrelation)과 meanTempogram 의 소요시간 / 결과 비교 (18.6초 세그먼트 1개)
+ *
+ * Copyright @2025 Gangglion. All rights reserved
+ */
+class TempogramBenchmarkJniTest : AssetFixtures() {
+
+    @Test
+    fun benchmarkTempogram_fastMatchesLegacy() = runTest {
+        val context = ApplicationProvider.getApplicationContext<Context>()
+        val audioPath = copyAssetToCache(context, "sample.mp3").absolutePath
+
+        val result = InferenceJniBridge().benchmarkTempogram(audioPath)!!
+        val (legacyMs, fastMs, maxRelDiff) = result.toList()
+        Log.i("glion", "Tempogram legacy :: $legacyMs ms, fast :: $fastMs ms (x${legacyMs / fastMs}), maxRelDiff :: $maxRelDiff")
+
+        // float 연산 오차 수준
+        assertTrue(maxRelDiff < 1e-4f)
+    }
+}
@@ -0,0 +1,39 @@
+package com.glion.ndk_essentia_test.embedding
+
+import android.content.Context
+import android.util.Log
+import androidx.test.core.app.ApplicationProvider
+import com.glion.ndk_essentia_test.InferenceJniBridge
+import kotlinx.coroutines.test.runTest
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertTrue
+import org.junit.Test
+
+/**
+ * Project : Resonance
+ * File : ThreadBudgetBenchmarkJniTest
+ * Created by glion on 2025-12-14
+ *
+ * Description:
+ * - 엔진 스레드 예산(특징 추출 + ORT + FFmpeg 공유)을 1 ~ 코어 수로 바꿔가며 embed 소요시간 측정
+ *
+ * Copyright @2025 Gangglion. All rights reserved
+ */
+class ThreadBudgetBenchmarkJniTest : AssetFixtures() {
+
+    @Test
+    fun benchmarkThreadBudget_sweepOneToCores() = runTest {
+        val context = ApplicationProvider.getApplicationContext<Context>()
+        val audioPath = copyAssetToCache(context, "sample.mp3").absolutePath
+        val modelPath = copyAssetToCache(context, "model.onnx").absolutePath
+        copyAssetToCache(context, "model.onnx.data")
+
+        val result = InferenceJniBridge().benchmarkThreadBudget(audioPath, modelPath)!!
+        result.forEachIndexed { index, ms ->
+            Log.i("glion", "스레드 예산 ${index + 1} :: $ms ms (x${result[0] / ms})")
+        }
+
+        assertEquals(Runtime.getRuntime().availableProcessors(), result.size)
+        assertTrue(result.all { it > 0f })
+    }
+}
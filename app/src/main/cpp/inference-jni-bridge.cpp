@@ -1,94 +1,362 @@
 #include <jni.h>
 #include <string>
+#include <stdexcept>
 
 #include "embedding_helper.h"
+#include "engine/embedding_engine.h"
 
 using namespace NdkEssentiaEmbedding;
 
+// jstring -> std::string 변환
+static std::string toStdString(JNIEnv* env, jstring str) {
+    const char *chars = env->GetStringUTFChars(str, nullptr);
+    std::string result(chars);
+    env->ReleaseStringUTFChars(str, chars);
+    return result;
+}
+
+// std::vector<float> -> jfloatArray 변환
+static jfloatArray toJavaFloatArray(JNIEnv* env, const std::vector<float>& values) {
+    jfloatArray javaResultArray = env->NewFloatArray(static_cast<jsize>(values.size()));
+    if (javaResultArray == nullptr) {
+        throw std::runtime_error("Failed to create new jfloatArray (Out of Memory).");
+    }
+    env->SetFloatArrayRegion(javaResultArray, 0, static_cast<jsize>(values.size()), values.data());
+    return javaResultArray;
+}
+
+// 단발성 전체 파이프라인 (경로 / fd 입력 공용)
+// (반복 호출 시에는 createEngine / embedWithEngine 사용 권장)
+static std::vector<float> runAllInferencePipeline(const AudioSource& source, const std::string& modelPath) {
+    // 기본 임베딩 저장소 조회 - 같은 곡 / 설정 / 모델로 이미 계산했다면 엔진 생성(모델 로드) 없이 반환
+    std::vector<float> storedEmbedding;
+    if (EmbeddingEngine::findStored(modelPath, source, storedEmbedding)) {
+        return storedEmbedding;
+    }
+
+    // 단발성 엔진으로 전체 파이프라인 수행 (결과는 기본 저장소에 추가됨)
+    EngineOptions options;
+    options.embedding_store = true;
+    EmbeddingEngine engine(modelPath, EmbeddingConfig(), options);
+    return engine.embed(source);
+}
+
 // 모든 과정 JNI 함수
 extern "C" JNIEXPORT jfloatArray JNICALL
 Java_com_glion_ndk_1essentia_1test_InferenceJniBridge_allInferencePipeline(
         JNIEnv* env,
         jobject thiz,
-        jstring filePath_,ㅕㅠ
+        jstring filePath_,
         jstring modelPath_
 ) {
     try {
         // 전체 과정 시간 측정
         RunTimerLogger timer("allInferencePipeline");
 
-        EmbeddingHelper resonanceEmd = EmbeddingHelper();
-
         // 1. JNI 입력 처리
-        const char *filePath = env->GetStringUTFChars(filePath_, nullptr);
-        std::string cppFilePath(filePath);
-        env->ReleaseStringUTFChars(filePath_, filePath);
+        std::string cppFilePath = toStdString(env, filePath_);
+        std::string modelPath = toStdString(env, modelPath_);
 
-        const char *modelPath = env->GetStringUTFChars(modelPath_, nullptr);
+        // 2. 전체 파이프라인 수행 후 최종 embedding 반환
+        return toJavaFloatArray(env, runAllInferencePipeline(cppFilePath, modelPath));
+    }
+    catch (const std::exception& e) {
+        // C++ 예외를 Java의 'java.lang.RuntimeException'으로 변환하여 던집니다.
+        // Kotlin/Java의 try-catch에서 이 예외를 잡을 수 있습니다.
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), e.what());
+        return nullptr; // Java/Kotlin 측에 null을 반환
+    }
+    catch (...) {
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), "Unknown C++ exception occurred in JNI.");
+        return nullptr;
+    }
+}
 
-        // 2. 순수 C++ 함수 호출
-        AudioData audioResults = resonanceEmd.loadAudioFile(cppFilePath);
+// 모든 과정 JNI 함수 - fd 구간 입력 (AssetFileDescriptor 등, 임시 파일 복사 없이 그 자리에서 디코딩)
+extern "C" JNIEXPORT jfloatArray JNICALL
+Java_com_glion_ndk_1essentia_1test_InferenceJniBridge_allInferencePipelineFd(
+        JNIEnv* env,
+        jobject thiz,
+        jint fd,
+        jlong offset,
+        jlong length,
+        jstring modelPath_
+) {
+    try {
+        RunTimerLogger timer("allInferencePipelineFd");
 
-        // 3. 세그먼트 분할
-        std::vector<std::vector<float>> segments = resonanceEmd.segmenter(audioResults);
+        std::string modelPath = toStdString(env, modelPath_);
+        return toJavaFloatArray(env, runAllInferencePipeline(AudioSource::fromFd(fd, offset, length), modelPath));
+    }
+    catch (const std::exception& e) {
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), e.what());
+        return nullptr;
+    }
+    catch (...) {
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), "Unknown C++ exception occurred in JNI.");
+        return nullptr;
+    }
+}
 
-        // 4. 세그먼트 별 특징 추출
-        // 모든 세그먼트의 FullFeatures(Mel, Chroma, Tempo)를 저장할 컨테이너
-        std::vector<FullFeatures> allSegmentFeatures;
-        // 모든 세그먼트 순회 및 특징 추출
-        for (const auto& segment : segments) {
-            // segment는 std::vector<float> 타입이며, extractFeatures의 첫 번째 인자로 사용됩니다.
+// 엔진 생성 - 모델 로드 및 Essentia 초기화를 1회만 수행하고 핸들 반환
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_glion_ndk_1essentia_1test_InferenceJniBridge_createEngine(
+        JNIEnv* env,
+        jobject thiz,
+        jstring modelPath_
+) {
+    try {
+        std::string modelPath = toStdString(env, modelPath_);
+        auto* engine = new EmbeddingEngine(modelPath);
+        return reinterpret_cast<jlong>(engine);
+    }
+    catch (const std::exception& e) {
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), e.what());
+        return 0;
+    }
+    catch (...) {
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), "Unknown C++ exception occurred in JNI.");
+        return 0;
+    }
+}
 
-            // 각 세그먼트에 대해 LogMel, Chroma, Tempo 특징을 동시에 추출합니다.
-            // config는 세그멘터에서 사용한 것과 동일한 객체를 사용하거나,
-            // 필요에 따라 이전에 정의한 설정을 사용합니다.
-            FullFeatures features = resonanceEmd.extractFeatures(segment);
+// 특징 캐시를 사용하는 엔진 생성 - (오디오 내용, 설정) 이 같은 곡은 모델이 바뀌어도 디코딩 / 특징 추출 생략
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_glion_ndk_1essentia_1test_InferenceJniBridge_createEngineWithFeatureCache(
+        JNIEnv* env,
+        jobject thiz,
+        jstring modelPath_,
+        jstring cacheDir_,
+        jboolean halfPrecision
+) {
+    try {
+        std::string modelPath = toStdString(env, modelPath_);
+        EngineOptions options;
+        options.feature_cache = true;
+        options.feature_cache_dir = toStdString(env, cacheDir_);
+        options.feature_cache_fp16 = halfPrecision == JNI_TRUE;
+        auto* engine = new EmbeddingEngine(modelPath, EmbeddingConfig(), options);
+        return reinterpret_cast<jlong>(engine);
+    }
+    catch (const std::exception& e) {
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), e.what());
+        return 0;
+    }
+    catch (...) {
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), "Unknown C++ exception occurred in JNI.");
+        return 0;
+    }
+}
 
-            // 결과 저장
-            allSegmentFeatures.push_back(std::move(features));
+// 임베딩 저장소를 사용하는 엔진 생성 - (오디오 내용, 설정, 모델) 이 같은 곡은 파이프라인 없이 저장된 임베딩 반환
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_glion_ndk_1essentia_1test_InferenceJniBridge_createEngineWithStore(
+        JNIEnv* env,
+        jobject thiz,
+        jstring modelPath_,
+        jstring storePath_
+) {
+    try {
+        std::string modelPath = toStdString(env, modelPath_);
+        EngineOptions options;
+        options.embedding_store = true;
+        options.embedding_store_path = toStdString(env, storePath_);
+        auto* engine = new EmbeddingEngine(modelPath, EmbeddingConfig(), options);
+        return reinterpret_cast<jlong>(engine);
+    }
+    catch (const std::exception& e) {
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), e.what());
+        return 0;
+    }
+    catch (...) {
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), "Unknown C++ exception occurred in JNI.");
+        return 0;
+    }
+}
+
+// 엔진 핸들로 임베딩 추출 (경로 / fd / 메모리 입력 공용)
+static std::vector<float> embedWithEngineHandle(jlong handle, const AudioSource& source) {
+    auto* engine = reinterpret_cast<EmbeddingEngine*>(handle);
+    if (engine == nullptr) {
+        throw std::invalid_argument("Engine handle is null. Call createEngine() first.");
+    }
+    return engine->embed(source);
+}
+
+// 엔진 핸들을 사용한 임베딩 추출
+extern "C" JNIEXPORT jfloatArray JNICALL
+Java_com_glion_ndk_1essentia_1test_InferenceJniBridge_embedWithEngine(
+        JNIEnv* env,
+        jobject thiz,
+        jlong handle,
+        jstring filePath_
+) {
+    try {
+        RunTimerLogger timer("embedWithEngine");
+
+        std::string cppFilePath = toStdString(env, filePath_);
+        std::vector<float> finalEmbedding = embedWithEngineHandle(handle, cppFilePath);
+        return toJavaFloatArray(env, finalEmbedding);
+    }
+    catch (const std::exception& e) {
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), e.what());
+        return nullptr;
+    }
+    catch (...) {
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), "Unknown C++ exception occurred in JNI.");
+        return nullptr;
+    }
+}
+
+// 엔진 핸들을 사용한 임베딩 추출 - fd 의 [offset, offset + length) 구간 (length < 0 이면 끝까지)
+extern "C" JNIEXPORT jfloatArray JNICALL
+Java_com_glion_ndk_1essentia_1test_InferenceJniBridge_embedWithEngineFd(
+        JNIEnv* env,
+        jobject thiz,
+        jlong handle,
+        jint fd,
+        jlong offset,
+        jlong length
+) {
+    try {
+        RunTimerLogger timer("embedWithEngineFd");
+
+        std::vector<float> finalEmbedding = embedWithEngineHandle(handle, AudioSource::fromFd(fd, offset, length));
+        return toJavaFloatArray(env, finalEmbedding);
+    }
+    catch (const std::exception& e) {
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), e.what());
+        return nullptr;
+    }
+    catch (...) {
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), "Unknown C++ exception occurred in JNI.");
+        return nullptr;
+    }
+}
+
+// 엔진 핸들을 사용한 임베딩 추출 - direct ByteBuffer 의 [position, limit) 를 복사 없이 디코딩
+extern "C" JNIEXPORT jfloatArray JNICALL
+Java_com_glion_ndk_1essentia_1test_InferenceJniBridge_embedWithEngineBuffer(
+        JNIEnv* env,
+        jobject thiz,
+        jlong handle,
+        jobject buffer,
+        jint position,
+        jint limit
+) {
+    try {
+        RunTimerLogger timer("embedWithEngineBuffer");
+
+        auto* data = static_cast<const uint8_t*>(env->GetDirectBufferAddress(buffer));
+        const jlong capacity = env->GetDirectBufferCapacity(buffer);
+        if (data == nullptr || capacity < 0) {
+            throw std::invalid_argument("Audio buffer must be a direct ByteBuffer.");
         }
-        // 모델 초기화
-        resonanceEmd.initOrtSession(modelPath);
-        env->ReleaseStringUTFChars(modelPath_, modelPath);
-
-        // 5. ONNX 모델 입력 텐서 생성
-        std::vector<Ort::Value> inputTensors = resonanceEmd.createInputTensors(allSegmentFeatures);
-        // 6. ONNX 모델 추론
-        std::vector<std::vector<float>> embeddingVector = resonanceEmd.runInference(inputTensors, "embedding");
-        // 7. ONNX 임베딩 후처리
-        // 7-1. 세그먼트별 정규화
-        for (auto& vec : embeddingVector) { // [V] 만큼 반복
-            resonanceEmd.l2Normalize(vec); // 1D 벡터용 헬퍼 함수 호출
+        if (position < 0 || limit < position || limit > capacity) {
+            throw std::invalid_argument("Audio buffer range is out of bounds.");
         }
-        // 7-2. 평균 풀링
-        std::vector<float> finalEmbedding = resonanceEmd.meanPooling(embeddingVector);
-        if (finalEmbedding.empty()) {
-            throw std::runtime_error("Mean pooling resulted in an empty vector.");
+
+        const AudioSource source = AudioSource::fromMemory(data + position, static_cast<size_t>(limit - position));
+        std::vector<float> finalEmbedding = embedWithEngineHandle(handle, source);
+        return toJavaFloatArray(env, finalEmbedding);
+    }
+    catch (const std::exception& e) {
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), e.what());
+        return nullptr;
+    }
+    catch (...) {
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), "Unknown C++ exception occurred in JNI.");
+        return nullptr;
+    }
+}
+
+// Kotlin 콜백에서 발생한 예외 (이미 JNI 에 pending 상태이므로 다시 ThrowNew 하지 않음)
+struct JavaCallbackException : std::runtime_error {
+    JavaCallbackException() : std::runtime_error("Exception thrown in Java callback.") {}
+};
+
+// 엔진 핸들을 사용한 라이브러리 일괄 인덱싱 - 완료된 곡마다 callback.onIndexed 호출 (호출 스레드에서 수행)
+extern "C" JNIEXPORT jint JNICALL
+Java_com_glion_ndk_1essentia_1test_InferenceJniBridge_indexLibrary(
+        JNIEnv* env,
+        jobject thiz,
+        jlong handle,
+        jobjectArray filePaths_,
+        jobject callback_
+) {
+    try {
+        RunTimerLogger timer("indexLibrary");
+
+        auto* engine = reinterpret_cast<EmbeddingEngine*>(handle);
+        if (engine == nullptr) {
+            throw std::invalid_argument("Engine handle is null. Call createEngine() first.");
+        }
+
+        // 1. 경로 배열 변환
+        const jsize count = env->GetArrayLength(filePaths_);
+        std::vector<std::string> filePaths;
+        filePaths.reserve(count);
+        for (jsize i = 0; i < count; ++i) {
+            auto path = static_cast<jstring>(env->GetObjectArrayElement(filePaths_, i));
+            filePaths.push_back(toStdString(env, path));
+            env->DeleteLocalRef(path);
         }
-        // 7-3. 최종 정규화
-        resonanceEmd.l2Normalize(finalEmbedding);
-
-        // 8. 최종 embedding 반환
-        size_t finalSize = finalEmbedding.size();
-        jfloatArray javaResultArray = env->NewFloatArray(static_cast<jsize>(finalSize));
-        if (javaResultArray == nullptr) {
-            throw std::runtime_error("Failed to create new jfloatArray (Out of Memory).");
+
+        // 2. 콜백 메서드 조회 - onIndexed(index, path, embedding?, error?)
+        jclass callbackClass = env->GetObjectClass(callback_);
+        jmethodID onIndexed = env->GetMethodID(
+                callbackClass, "onIndexed", "(ILjava/lang/String;[FLjava/lang/String;)V");
+        env->DeleteLocalRef(callbackClass);
+        if (onIndexed == nullptr) {
+            return -1; // NoSuchMethodError pending
         }
-        env->SetFloatArrayRegion(javaResultArray, 0, static_cast<jsize>(finalSize), finalEmbedding.data());
-        return javaResultArray;
+
+        // 3. 파이프라인 실행 (콜백은 이 스레드에서 호출되므로 JNIEnv 그대로 사용)
+        size_t succeeded = engine->embedAll(filePaths, [&](size_t index,
+                                                           const std::string& path,
+                                                           const std::vector<float>& embedding,
+                                                           const std::string& error) {
+            // 곡 수만큼 호출되므로 로컬 참조는 매번 해제
+            jstring jPath = env->NewStringUTF(path.c_str());
+            jfloatArray jEmbedding = error.empty() ? toJavaFloatArray(env, embedding) : nullptr;
+            jstring jError = error.empty() ? nullptr : env->NewStringUTF(error.c_str());
+
+            env->CallVoidMethod(callback_, onIndexed, static_cast<jint>(index), jPath, jEmbedding, jError);
+
+            env->DeleteLocalRef(jPath);
+            if (jEmbedding) env->DeleteLocalRef(jEmbedding);
+            if (jError) env->DeleteLocalRef(jError);
+
+            if (env->ExceptionCheck()) {
+                throw JavaCallbackException();
+            }
+        });
+
+        return static_cast<jint>(succeeded);
+    }
+    catch (const JavaCallbackException&) {
+        return -1; // Kotlin 측 예외가 그대로 전파됨
     }
     catch (const std::exception& e) {
-        // C++ 예외를 Java의 'java.lang.RuntimeException'으로 변환하여 던집니다.
-        // Kotlin/Java의 try-catch에서 이 예외를 잡을 수 있습니다.
         env->ThrowNew(env->FindClass("java/lang/RuntimeException"), e.what());
-        return nullptr; // Java/Kotlin 측에 null을 반환
+        return -1;
     }
     catch (...) {
         env->ThrowNew(env->FindClass("java/lang/RuntimeException"), "Unknown C++ exception occurred in JNI.");
-        return nullptr;
+        return -1;
     }
 }
 
+// 엔진 해제 - ORT 세션 해제 및 (마지막 인스턴스라면) Essentia shutdown
+extern "C" JNIEXPORT void JNICALL
+Java_com_glion_ndk_1essentia_1test_InferenceJniBridge_destroyEngine(
+        JNIEnv* env,
+        jobject thiz,
+        jlong handle
+) {
+    delete reinterpret_cast<EmbeddingEngine*>(handle);
+}
+
 // temp : 테스트 - 특정 특징 추출하여 코사인 유사도 비교용
 extern "C" JNIEXPORT jfloatArray JNICALL
 Java_com_glion_ndk_1essentia_1test_InferenceJniBridge_getFlattenFeature(
@@ -103,27 +371,22 @@ Java_com_glion_ndk_1essentia_1test_InferenceJniBridge_getFlattenFeature(
         EmbeddingHelper resonanceEmd = EmbeddingHelper();
 
         // 1. JNI 입력 처리
-        const char *filePath = env->GetStringUTFChars(filePath_, nullptr);
-        std::string cppFilePath(filePath);
-        env->ReleaseStringUTFChars(filePath_, filePath);
-
-        const char *typePtr = env->GetStringUTFChars(type_, nullptr);
-        std::string type(typePtr);
-        env->ReleaseStringUTFChars(type_, typePtr);
+        std::string cppFilePath = toStdString(env, filePath_);
+        std::string type = toStdString(env, type_);
 
 
         // 2. 순수 C++ 함수 호출
         AudioData audioResults = resonanceEmd.loadAudioFile(cppFilePath);
 
         // 3. 세그먼트 분할
-        std::vector<std::vector<float>> segments = resonanceEmd.segmenter(audioResults);
+        std::vector<AudioView> segments = resonanceEmd.segmenter(audioResults);
 
         // 4. 세그먼트 별 특징 추출
         // 모든 세그먼트의 FullFeatures(Mel, Chroma, Tempo)를 저장할 컨테이너
         std::vector<FullFeatures> allSegmentFeatures;
         // 모든 세그먼트 순회 및 특징 추출
         for (const auto& segment : segments) {
-            // segment는 std::vector<float> 타입이며, extractFeatures의 첫 번째 인자로 사용됩니다.
+            // segment는 audioResults.samples 를 가리키는 AudioView 이며, extractFeatures의 첫 번째 인자로 사용됩니다.
 
             // 각 세그먼트에 대해 LogMel, Chroma, Tempo 특징을 동시에 추출합니다.
             // config는 세그멘터에서 사용한 것과 동일한 객체를 사용하거나,
@@ -149,13 +412,7 @@ Java_com_glion_ndk_1essentia_1test_InferenceJniBridge_getFlattenFeature(
         }
 
         // 7. 최종 값 floatArray 로 리턴
-        size_t finalSize = resultAtType.size();
-        jfloatArray javaResultArray = env->NewFloatArray(static_cast<jsize>(finalSize));
-        if (javaResultArray == nullptr) {
-            throw std::runtime_error("Failed to create new jfloatArray (Out of Memory).");
-        }
-        env->SetFloatArrayRegion(javaResultArray, 0, static_cast<jsize>(finalSize), resultAtType.data());
-        return javaResultArray;
+        return toJavaFloatArray(env, resultAtType);
 
     }
     catch (const std::exception& e) {
@@ -169,3 +426,134 @@ Java_com_glion_ndk_1essentia_1test_InferenceJniBridge_getFlattenFeature(
         return nullptr;
     }
 }
+
+// temp : 테스트 - 기존 Essentia STFT 체인 대비 StftEngine 벤치마크 (첫 세그먼트 사용)
+extern "C" JNIEXPORT jfloatArray JNICALL
+Java_com_glion_ndk_1essentia_1test_InferenceJniBridge_benchmarkStft(
+        JNIEnv* env,
+        jobject thiz,
+        jstring filePath_) {
+    try {
+        EmbeddingHelper resonanceEmd = EmbeddingHelper();
+
+        std::string cppFilePath = toStdString(env, filePath_);
+        SegmentedAudio audio = resonanceEmd.loadAudioSegments(cppFilePath);
+        if (audio.empty()) {
+            throw std::runtime_error("No segments to benchmark : " + cppFilePath);
+        }
+
+        return toJavaFloatArray(env, resonanceEmd.benchmarkStft(audio.segments.front()));
+    }
+    catch (const std::exception& e) {
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), e.what());
+        return nullptr;
+    }
+    catch (...) {
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), "Unknown C++ exception occurred in JNI.");
+        return nullptr;
+    }
+}
+
+// temp : 테스트 - 기존 2D 템포그램 평균 대비 meanTempogram 벤치마크 (첫 세그먼트 사용)
+extern "C" JNIEXPORT jfloatArray JNICALL
+Java_com_glion_ndk_1essentia_1test_InferenceJniBridge_benchmarkTempogram(
+        JNIEnv* env,
+        jobject thiz,
+        jstring filePath_) {
+    try {
+        EmbeddingHelper resonanceEmd = EmbeddingHelper();
+
+        std::string cppFilePath = toStdString(env, filePath_);
+        SegmentedAudio audio = resonanceEmd.loadAudioSegments(cppFilePath);
+        if (audio.empty()) {
+            throw std::runtime_error("No segments to benchmark : " + cppFilePath);
+        }
+
+        return toJavaFloatArray(env, resonanceEmd.benchmarkTempogram(audio.segments.front()));
+    }
+    catch (const std::exception& e) {
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), e.what());
+        return nullptr;
+    }
+    catch (...) {
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), "Unknown C++ exception occurred in JNI.");
+        return nullptr;
+    }
+}
+
+// temp : 테스트 - 구간 디코딩과 전체 디코딩 + segmenter 의 세그먼트 샘플 비교
+extern "C" JNIEXPORT jfloatArray JNICALL
+Java_com_glion_ndk_1essentia_1test_InferenceJniBridge_compareSegmentDecode(
+        JNIEnv* env,
+        jobject thiz,
+        jstring filePath_) {
+    try {
+        EmbeddingHelper resonanceEmd = EmbeddingHelper();
+
+        std::string cppFilePath = toStdString(env, filePath_);
+        return toJavaFloatArray(env, resonanceEmd.compareSegmentDecode(cppFilePath));
+    }
+    catch (const std::exception& e) {
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), e.what());
+        return nullptr;
+    }
+    catch (...) {
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), "Unknown C++ exception occurred in JNI.");
+        return nullptr;
+    }
+}
+
+// temp : 테스트 - 스레드 예산 1 ~ 코어 수 별 embed 소요시간 벤치마크
+extern "C" JNIEXPORT jfloatArray JNICALL
+Java_com_glion_ndk_1essentia_1test_InferenceJniBridge_benchmarkThreadBudget(
+        JNIEnv* env,
+        jobject thiz,
+        jstring filePath_,
+        jstring modelPath_) {
+    try {
+        std::string cppFilePath = toStdString(env, filePath_);
+        std::string modelPath = toStdString(env, modelPath_);
+
+        return toJavaFloatArray(env, EmbeddingEngine::benchmarkThreadBudget(modelPath, cppFilePath));
+    }
+    catch (const std::exception& e) {
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), e.what());
+        return nullptr;
+    }
+    catch (...) {
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), "Unknown C++ exception occurred in JNI.");
+        return nullptr;
+    }
+}
+
+// temp : 테스트 - 엔진의 저장소 / 특징 캐시 적중 횟수
+extern "C" JNIEXPORT jlongArray JNICALL
+Java_com_glion_ndk_1essentia_1test_InferenceJniBridge_getCacheStats(
+        JNIEnv* env,
+        jobject thiz,
+        jlong handle
+) {
+    try {
+        auto* engine = reinterpret_cast<EmbeddingEngine*>(handle);
+        if (engine == nullptr) {
+            throw std::invalid_argument("Engine handle is null. Call createEngine() first.");
+        }
+        const EmbeddingEngine::CacheStats stats = engine->cacheStats();
+        const jlong values[4] = {
+                static_cast<jlong>(stats.store_hits),
+                static_cast<jlong>(stats.fingerprint_hits),
+                static_cast<jlong>(stats.feature_cache_hits),
+                static_cast<jlong>(stats.store_records)
+        };
+        jlongArray result = env->NewLongArray(4);
+        if (result == nullptr) {
+            throw std::runtime_error("Failed to create new jlongArray (Out of Memory).");
+        }
+        env->SetLongArrayRegion(result, 0, 4, values);
+        return result;
+    }
+    catch (const std::exception& e) {
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), e.what());
+        return nullptr;
+    }
+}
@@ -0,0 +1,235 @@
+//
+// Created by glion on 2025-12-22.
+// ContentDigest 구현
+//
+
+#include "cache/content_digest.h"
+#include "common/hash_util.h"
+#include "common/cal_runtime.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace NdkEssentiaEmbedding;
+
+namespace {
+    constexpr char DIGEST_MAGIC[8] = {'R', 'S', 'N', 'C', 'D', 'G', '0', '1'};
+    // 한 번에 읽는 레코드 수
+    constexpr size_t READ_BATCH = 256;
+
+    int64_t mtimeNs(const struct stat& st) {
+        return static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+    }
+
+    bool writeFully(int fd, const void* data, size_t size, off_t offset) {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        while (size > 0) {
+            const ssize_t written = ::pwrite(fd, bytes, size, offset);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            bytes += written;
+            size -= static_cast<size_t>(written);
+            offset += written;
+        }
+        return true;
+    }
+
+    void lockExclusive(int fd) {
+        while (::flock(fd, LOCK_EX) != 0 && errno == EINTR) {}
+    }
+}
+
+ContentDigest::ContentDigest(const std::string& path) : m_path(path) {
+    static_assert(sizeof(Record) == 8 * sizeof(uint64_t), "content digest record must be packed");
+
+    m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (m_fd < 0) {
+        throw std::runtime_error("Failed to open content digest : " + path + " (" + std::strerror(errno) + ")");
+    }
+
+    // 헤더가 없거나 다르면 초기화 (배타 잠금 - 다른 프로세스의 덧붙이기와 겹치지 않음)
+    lockExclusive(m_fd);
+    char magic[sizeof(DIGEST_MAGIC)] = {};
+    const bool valid = ::pread(m_fd, magic, sizeof(magic), 0) == static_cast<ssize_t>(sizeof(magic))
+                       && std::memcmp(magic, DIGEST_MAGIC, sizeof(magic)) == 0;
+    const bool ok = valid || (::ftruncate(m_fd, 0) == 0 && writeFully(m_fd, DIGEST_MAGIC, sizeof(DIGEST_MAGIC), 0));
+    ::flock(m_fd, LOCK_UN);
+    if (!ok) {
+        ::close(m_fd);
+        throw std::runtime_error("Failed to initialize content digest : " + path + " (" + std::strerror(errno) + ")");
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    readTail();
+    LOGI("Content digest opened : %zu records %s", m_index.size(), m_path.c_str());
+}
+
+ContentDigest::~ContentDigest() {
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+}
+
+std::shared_ptr<ContentDigest> ContentDigest::shared(const std::string& path) {
+    static std::mutex mutex;
+    static std::map<std::string, std::weak_ptr<ContentDigest>> digests;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_ptr<ContentDigest> digest = digests[path].lock();
+    if (!digest) {
+        digest = std::make_shared<ContentDigest>(path);
+        digests[path] = digest;
+    }
+    return digest;
+}
+
+std::string ContentDigest::defaultPath(const std::string& modelPath) {
+    const size_t slash = modelPath.find_last_of('/');
+    const std::string dir = slash == std::string::npos ? "." : modelPath.substr(0, slash);
+    return dir + "/content.digest";
+}
+
+bool ContentDigest::identify(const AudioSource& source, Identity& id, Stamp& stamp) {
+    struct stat st{};
+    if (source.isPath()) {
+        if (::stat(source.path().c_str(), &st) != 0) return false;
+        id.offset = 0;
+        id.length = -1;
+    } else if (source.kind() == AudioSource::Kind::Fd) {
+        if (::fstat(source.fd(), &st) != 0) return false;
+        id.offset = source.offset();
+        id.length = source.size();
+    } else {
+        return false;
+    }
+    // 파이프 / 소켓 등은 내용이 고정되지 않으므로 제외
+    if (!S_ISREG(st.st_mode)) return false;
+    id.dev = static_cast<uint64_t>(st.st_dev);
+    id.inode = static_cast<uint64_t>(st.st_ino);
+    stamp.size = static_cast<int64_t>(st.st_size);
+    stamp.mtime = mtimeNs(st);
+    return true;
+}
+
+uint64_t ContentDigest::checksum(const Record& record) {
+    Fnv1aHasher hasher;
+    hasher.update(&record, sizeof(Record) - sizeof(record.checksum));
+    return hasher.value();
+}
+
+bool ContentDigest::hash(const AudioSource& source, uint64_t& hash) {
+    Identity id;
+    Stamp stamp;
+    if (!identify(source, id, stamp)) {
+        return hashAudioContent(source, hash);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_index.find(id);
+        if (it == m_index.end() || !(it->second.first == stamp)) {
+            // 다른 프로세스가 계산해 둔 값이 있을 수 있음
+            readTail();
+            it = m_index.find(id);
+        }
+        if (it != m_index.end() && it->second.first == stamp) {
+            hash = it->second.second;
+            return true;
+        }
+    }
+
+    // 파일 전체 해시 (잠금 밖에서 수행 - 다른 곡의 조회를 막지 않음)
+    {
+        RunTimerLogger timer("hash audio content");
+        if (!hashAudioContent(source, hash)) {
+            return false;
+        }
+    }
+
+    // 해시하는 동안 파일이 바뀌었으면 저장하지 않음 (다음 조회에서 다시 계산)
+    Identity after;
+    Stamp afterStamp;
+    if (!identify(source, after, afterStamp) || !(after == id) || !(afterStamp == stamp)) {
+        return true;
+    }
+
+    Record record;
+    record.id = id;
+    record.stamp = stamp;
+    record.hash = hash;
+    record.checksum = checksum(record);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    append(record);
+    return true;
+}
+
+void ContentDigest::readTail() {
+    struct stat st{};
+    if (::fstat(m_fd, &st) != 0) {
+        return;
+    }
+    const size_t fileSize = static_cast<size_t>(st.st_size);
+    if (fileSize < m_fileSize) {
+        // 다른 프로세스가 비움 - 처음부터 다시 읽음 (남은 인덱스는 스탬프로 검증되므로 유지)
+        m_fileSize = HEADER_SIZE;
+    }
+
+    std::vector<Record> records(READ_BATCH);
+    while (m_fileSize + sizeof(Record) <= fileSize) {
+        const size_t count = std::min(READ_BATCH, (fileSize - m_fileSize) / sizeof(Record));
+        const ssize_t read = ::pread(m_fd, records.data(), count * sizeof(Record), static_cast<off_t>(m_fileSize));
+        if (read <= 0) {
+            return;
+        }
+        const size_t complete = static_cast<size_t>(read) / sizeof(Record);
+        for (size_t i = 0; i < complete; ++i) {
+            const Record& record = records[i];
+            // 쓰는 중이거나 깨진 레코드 - 여기까지만 인덱싱 (다음 덧붙이기에서 잘라냄)
+            if (record.checksum != checksum(record)) {
+                return;
+            }
+            m_index[record.id] = {record.stamp, record.hash};
+            m_fileSize += sizeof(Record);
+        }
+        if (complete == 0) {
+            return;
+        }
+    }
+}
+
+void ContentDigest::append(const Record& record) {
+    lockExclusive(m_fd);
+    // 배타 잠금 중에는 쓰는 중인 레코드가 없으므로 인덱싱되지 않은 꼬리는 중단된 덧붙이기의 잔여물 - 잘라냄
+    readTail();
+    bool ok = true;
+    if (m_fileSize - HEADER_SIZE >= MAX_RECORDS * sizeof(Record)) {
+        m_index.clear();
+        m_fileSize = HEADER_SIZE;
+    }
+    struct stat st{};
+    if (::fstat(m_fd, &st) != 0 || static_cast<size_t>(st.st_size) != m_fileSize) {
+        ok = ::ftruncate(m_fd, static_cast<off_t>(m_fileSize)) == 0;
+    }
+    ok = ok && writeFully(m_fd, &record, sizeof(record), static_cast<off_t>(m_fileSize));
+    if (ok) {
+        m_fileSize += sizeof(Record);
+    }
+    ::flock(m_fd, LOCK_UN);
+
+    if (!ok) {
+        // 다음 조회에서 다시 계산할 뿐이므로 경고만
+        LOGW("Failed to store content digest : %s (%s)", m_path.c_str(), std::strerror(errno));
+    }
+    m_index[record.id] = {record.stamp, record.hash};
+}
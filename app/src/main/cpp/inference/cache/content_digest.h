@@ -0,0 +1,105 @@
+//
+// Created by glion on 2025-12-22.
+// 오디오 내용 해시 영속 캐시 - 파일 전체 내용 해시를 (dev, inode, 구간, 크기, 수정 시각) 스탬프와 함께 저장
+// 저장소 / 특징 캐시 / PCM 캐시의 내용 키는 파일 전체 해시여야 하지만(일부만 바뀐 같은 크기 파일 구분), 적중 조회마다
+// 파일 전체를 읽지 않도록 스탬프가 같으면 저장된 해시 사용 (모델 해시의 <model>.digest 와 같은 방식)
+// 여러 프로세스가 같은 파일을 열 수 있음 - 덧붙이기는 flock 배타 잠금, 다른 프로세스가 추가한 레코드는 미적중 시 따라잡음
+//
+// 파일 구조 (네이티브 엔디언)
+//  - 헤더 8바이트 : magic[8] "RSNCDG01"
+//  - 레코드      : uint64 dev, uint64 inode, int64 offset, int64 length, int64 size, int64 mtime(ns), uint64 hash, uint64 checksum
+//
+
+#ifndef NDK_ESSENTIA_TEST_CONTENT_DIGEST_H
+#define NDK_ESSENTIA_TEST_CONTENT_DIGEST_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "common/audio_source.h"
+
+namespace NdkEssentiaEmbedding {
+
+    class ContentDigest {
+    public:
+        // 파일을 열어(없으면 생성) 전체 레코드를 인덱싱. 실패 시 std::runtime_error
+        explicit ContentDigest(const std::string& path);
+        ~ContentDigest();
+
+        ContentDigest(const ContentDigest&) = delete;
+        ContentDigest& operator=(const ContentDigest&) = delete;
+
+        // 같은 경로는 프로세스 전체에서 1개만 열어 공유
+        static std::shared_ptr<ContentDigest> shared(const std::string& path);
+
+        // 모델 파일과 같은 디렉터리의 기본 경로 (<모델 디렉터리>/content.digest)
+        static std::string defaultPath(const std::string& modelPath);
+
+        // 입력 전체 내용 해시 (hashAudioContent 와 같은 값). 읽을 수 없으면 false
+        // 경로 / fd 입력은 스탬프가 같으면 저장된 값을 사용하고, 없으면 전체를 읽어 계산한 뒤 저장
+        // 메모리 입력은 식별할 스탬프가 없으므로 매번 계산
+        bool hash(const AudioSource& source, uint64_t& hash);
+
+    private:
+        // 입력 식별 (같은 파일의 같은 구간)
+        struct Identity {
+            uint64_t dev = 0;
+            uint64_t inode = 0;
+            int64_t offset = 0;
+            int64_t length = 0;
+
+            bool operator==(const Identity& other) const {
+                return dev == other.dev && inode == other.inode && offset == other.offset && length == other.length;
+            }
+        };
+
+        struct IdentityHash {
+            size_t operator()(const Identity& id) const {
+                uint64_t h = id.inode;
+                h ^= id.dev + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+                h ^= static_cast<uint64_t>(id.offset) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+                h ^= static_cast<uint64_t>(id.length) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+                return static_cast<size_t>(h);
+            }
+        };
+
+        // 파일 변경 여부 판단용 스탬프 (파일 전체 크기, 수정 시각 ns)
+        struct Stamp {
+            int64_t size = 0;
+            int64_t mtime = 0;
+
+            bool operator==(const Stamp& other) const { return size == other.size && mtime == other.mtime; }
+        };
+
+        struct Record {
+            Identity id;
+            Stamp stamp;
+            uint64_t hash = 0;
+            uint64_t checksum = 0;
+        };
+
+        static constexpr size_t HEADER_SIZE = 8;
+        // 삭제된 파일의 레코드는 알 수 없으므로 이 수를 넘으면 파일을 비움 (이후 조회에서 다시 계산될 뿐)
+        static constexpr size_t MAX_RECORDS = 65536;
+
+        // 경로 / fd 입력의 식별 / 스탬프 (정규 파일이 아니거나 메모리 입력이면 false)
+        static bool identify(const AudioSource& source, Identity& id, Stamp& stamp);
+        static uint64_t checksum(const Record& record);
+
+        // 인덱싱한 위치 이후 다른 프로세스가 추가한 레코드 반영 (잠금 없이 읽음 - 쓰는 중인 레코드는 체크섬으로 걸러짐)
+        void readTail();
+        void append(const Record& record);
+
+        std::string m_path;
+        int m_fd = -1;
+        size_t m_fileSize = HEADER_SIZE; // 인덱싱한 위치
+
+        std::unordered_map<Identity, std::pair<Stamp, uint64_t>, IdentityHash> m_index;
+        std::mutex m_mutex;
+    };
+}
+
+#endif //NDK_ESSENTIA_TEST_CONTENT_DIGEST_H
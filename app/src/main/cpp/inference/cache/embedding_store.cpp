@@ -0,0 +1,350 @@
+//
+// Created by glion on 2025-12-17.
+// EmbeddingStore 구현
+//
+
+#include "cache/embedding_store.h"
+#include "common/hash_util.h"
+#include "common/cal_runtime.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace NdkEssentiaEmbedding;
+
+namespace {
+    constexpr char STORE_MAGIC[8] = {'R', 'S', 'N', 'E', 'M', 'B', '0', '1'};
+    constexpr uint32_t STORE_VERSION = 1;
+
+    bool writeFully(int fd, const void* data, size_t size, off_t offset) {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        while (size > 0) {
+            const ssize_t written = ::pwrite(fd, bytes, size, offset);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            bytes += written;
+            size -= static_cast<size_t>(written);
+            offset += written;
+        }
+        return true;
+    }
+
+    bool readFully(int fd, void* data, size_t size, off_t offset) {
+        auto* bytes = static_cast<uint8_t*>(data);
+        while (size > 0) {
+            const ssize_t read = ::pread(fd, bytes, size, offset);
+            if (read < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            if (read == 0) return false; // 파일 끝 (다른 프로세스가 초기화함)
+            bytes += read;
+            size -= static_cast<size_t>(read);
+            offset += read;
+        }
+        return true;
+    }
+}
+
+EmbeddingStore::EmbeddingStore(const std::string& path, uint64_t currentModel)
+        : m_path(path), m_currentModel(currentModel) {
+    RunTimerLogger timer("EmbeddingStore open");
+
+    openFile();
+    lockFile(LOCK_EX);
+    try {
+        sync(true);
+        compactIfSparse();
+    } catch (...) {
+        unlockFile();
+        throw;
+    }
+    unlockFile();
+    LOGI("Embedding store opened : %zu records (dim %u) %s", m_index.size(), m_dim, m_path.c_str());
+}
+
+EmbeddingStore::~EmbeddingStore() {
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+}
+
+std::shared_ptr<EmbeddingStore> EmbeddingStore::shared(const std::string& path, uint64_t currentModel) {
+    static std::mutex mutex;
+    static std::map<std::string, std::weak_ptr<EmbeddingStore>> stores;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_ptr<EmbeddingStore> store = stores[path].lock();
+    if (!store) {
+        store = std::make_shared<EmbeddingStore>(path, currentModel);
+        stores[path] = store;
+    }
+    return store;
+}
+
+std::string EmbeddingStore::defaultPath(const std::string& modelPath) {
+    return modelPath + ".store";
+}
+
+uint64_t EmbeddingStore::checksum(const EmbeddingKey& key, const float* embedding, size_t dim) {
+    Fnv1aHasher hasher;
+    hasher.update(&key.content, sizeof(key.content));
+    hasher.update(&key.config, sizeof(key.config));
+    hasher.update(&key.model, sizeof(key.model));
+    hasher.update(embedding, dim * sizeof(float));
+    return hasher.value();
+}
+
+void EmbeddingStore::openFile() {
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+    m_fd = ::open(m_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (m_fd < 0) {
+        throw std::runtime_error("Failed to open embedding store : " + m_path + " (" + std::strerror(errno) + ")");
+    }
+    clearIndex(0);
+}
+
+void EmbeddingStore::lockFile(int op) {
+    while (true) {
+        if (::flock(m_fd, op) != 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error("Failed to lock embedding store : " + m_path + " (" + std::strerror(errno) + ")");
+        }
+        // 잠금 대기 중 다른 프로세스가 압축(새 파일로 rename)했거나 파일이 삭제되었으면 경로의 현재 파일로 다시 열기
+        struct stat opened{};
+        struct stat current{};
+        if (::fstat(m_fd, &opened) == 0 && ::stat(m_path.c_str(), &current) == 0
+            && opened.st_dev == current.st_dev && opened.st_ino == current.st_ino) {
+            return;
+        }
+        ::flock(m_fd, LOCK_UN);
+        openFile();
+    }
+}
+
+void EmbeddingStore::unlockFile() {
+    ::flock(m_fd, LOCK_UN);
+}
+
+void EmbeddingStore::clearIndex(uint32_t dim) {
+    m_index.clear();
+    m_dim = dim;
+    m_fileSize = HEADER_SIZE;
+    m_records = 0;
+}
+
+void EmbeddingStore::sync(bool exclusive) {
+    struct stat st{};
+    if (::fstat(m_fd, &st) != 0) {
+        throw std::runtime_error("Failed to stat embedding store : " + m_path);
+    }
+    const size_t fileSize = static_cast<size_t>(st.st_size);
+
+    // 헤더 확인 (비어있거나 다른 형식이면 빈 저장소 - 첫 append 에서 차원 확정)
+    uint8_t header[HEADER_SIZE] = {};
+    uint32_t version = 0;
+    uint32_t dim = 0;
+    const bool valid = fileSize >= HEADER_SIZE && readFully(m_fd, header, HEADER_SIZE, 0)
+                       && std::memcmp(header, STORE_MAGIC, sizeof(STORE_MAGIC)) == 0;
+    if (valid) {
+        std::memcpy(&version, header + 8, sizeof(version));
+        std::memcpy(&dim, header + 12, sizeof(dim));
+    }
+    if (!valid || version != STORE_VERSION) {
+        if (fileSize > 0) {
+            LOGW("Embedding store has no valid header (version %u), starting empty : %s", version, m_path.c_str());
+        }
+        if (exclusive) {
+            reset(0);
+        } else {
+            clearIndex(0);
+        }
+        return;
+    }
+
+    // 다른 프로세스가 초기화(차원 변경)했으면 처음부터 다시 인덱싱
+    if (dim != m_dim || fileSize < m_fileSize) {
+        clearIndex(dim);
+    }
+    if (m_dim == 0) {
+        return;
+    }
+
+    // 새로 추가된 레코드 인덱싱. 중간에 종료되어 잘린 / 깨진 꼬리 레코드에서 중단
+    const size_t record = recordSize();
+    std::vector<uint8_t> chunk(record * 256);
+    size_t offset = m_fileSize;
+    bool corrupted = false;
+    while (offset + record <= fileSize && !corrupted) {
+        const size_t count = std::min(chunk.size(), (fileSize - offset) / record * record);
+        if (!readFully(m_fd, chunk.data(), count, static_cast<off_t>(offset))) {
+            break;
+        }
+        for (size_t pos = 0; pos < count; pos += record) {
+            EmbeddingKey key;
+            uint64_t stored = 0;
+            std::memcpy(&key.content, chunk.data() + pos, sizeof(uint64_t));
+            std::memcpy(&key.config, chunk.data() + pos + 8, sizeof(uint64_t));
+            std::memcpy(&key.model, chunk.data() + pos + 16, sizeof(uint64_t));
+            std::memcpy(&stored, chunk.data() + pos + 24, sizeof(uint64_t));
+            const auto* embedding = reinterpret_cast<const float*>(chunk.data() + pos + KEY_SIZE);
+            if (checksum(key, embedding, m_dim) != stored) {
+                LOGW("Embedding store record at %zu is corrupted", offset);
+                corrupted = true;
+                break;
+            }
+            m_index[key] = offset;
+            offset += record;
+            ++m_records;
+        }
+    }
+    m_fileSize = offset;
+    if (exclusive && offset != fileSize && ::ftruncate(m_fd, static_cast<off_t>(offset)) == 0) {
+        LOGW("Embedding store truncated to %zu bytes : %s", offset, m_path.c_str());
+    }
+}
+
+void EmbeddingStore::compactIfSparse() {
+    size_t live = 0;
+    for (const auto& entry : m_index) {
+        if (m_currentModel == 0 || entry.first.model == m_currentModel) ++live;
+    }
+    if (m_records < COMPACT_MIN_RECORDS || live * 2 >= m_records) {
+        return;
+    }
+    RunTimerLogger timer("EmbeddingStore compact");
+
+    // 유효 레코드만 임시 파일에 기록 후 rename (중간에 종료되어도 원본 유지)
+    // 다른 프로세스는 다음 잠금에서 경로의 inode 가 바뀐 것을 보고 다시 엶
+    const std::string tmpPath = m_path + ".tmp" + std::to_string(::gettid());
+    const int tmpFd = ::open(tmpPath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (tmpFd < 0) {
+        LOGW("Embedding store compaction skipped : %s (%s)", tmpPath.c_str(), std::strerror(errno));
+        return;
+    }
+
+    uint8_t header[HEADER_SIZE] = {};
+    std::memcpy(header, STORE_MAGIC, sizeof(STORE_MAGIC));
+    std::memcpy(header + 8, &STORE_VERSION, sizeof(STORE_VERSION));
+    std::memcpy(header + 12, &m_dim, sizeof(m_dim));
+    bool ok = writeFully(tmpFd, header, HEADER_SIZE, 0);
+
+    const size_t record = recordSize();
+    std::vector<uint8_t> buffer(record);
+    size_t offset = HEADER_SIZE;
+    for (const auto& entry : m_index) {
+        if (!ok) break;
+        if (m_currentModel != 0 && entry.first.model != m_currentModel) continue;
+        ok = readFully(m_fd, buffer.data(), record, static_cast<off_t>(entry.second))
+             && writeFully(tmpFd, buffer.data(), record, static_cast<off_t>(offset));
+        offset += record;
+    }
+    ok = ::fsync(tmpFd) == 0 && ok;
+    ::close(tmpFd);
+    if (!ok || std::rename(tmpPath.c_str(), m_path.c_str()) != 0) {
+        LOGW("Embedding store compaction failed : %s (%s)", m_path.c_str(), std::strerror(errno));
+        ::unlink(tmpPath.c_str());
+        return;
+    }
+    LOGI("Embedding store compacted : %zu -> %zu records %s", m_records, live, m_path.c_str());
+
+    // 압축된 파일로 다시 열어 인덱싱
+    unlockFile();
+    openFile();
+    lockFile(LOCK_EX);
+    sync(true);
+}
+
+void EmbeddingStore::reset(uint32_t dim) {
+    clearIndex(dim);
+
+    uint8_t header[HEADER_SIZE] = {};
+    std::memcpy(header, STORE_MAGIC, sizeof(STORE_MAGIC));
+    std::memcpy(header + 8, &STORE_VERSION, sizeof(STORE_VERSION));
+    std::memcpy(header + 12, &m_dim, sizeof(m_dim));
+
+    if (::ftruncate(m_fd, 0) != 0 || !writeFully(m_fd, header, HEADER_SIZE, 0)) {
+        throw std::runtime_error("Failed to initialize embedding store : " + m_path);
+    }
+}
+
+bool EmbeddingStore::lookup(const EmbeddingKey& key, std::vector<float>& out) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(key);
+    if (it == m_index.end()) {
+        // 다른 프로세스가 추가한 레코드가 있는지 확인
+        lockFile(LOCK_SH);
+        try {
+            sync(false);
+        } catch (...) {
+            unlockFile();
+            throw;
+        }
+        unlockFile();
+        it = m_index.find(key);
+        if (it == m_index.end()) {
+            return false;
+        }
+    }
+    out.resize(m_dim);
+    if (!readFully(m_fd, out.data(), m_dim * sizeof(float), static_cast<off_t>(it->second + KEY_SIZE))) {
+        out.clear();
+        return false;
+    }
+    return true;
+}
+
+void EmbeddingStore::append(const EmbeddingKey& key, const std::vector<float>& embedding) {
+    if (embedding.empty()) return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    lockFile(LOCK_EX);
+    try {
+        // 다른 프로세스가 추가한 레코드 뒤에 이어서 기록
+        sync(true);
+        if (m_dim != embedding.size()) {
+            // 차원이 다른 모델의 레코드는 더 이상 적중할 수 없으므로 비우고 새 차원으로 시작
+            if (m_dim != 0) {
+                LOGW("Embedding dimension changed (%u -> %zu), clearing store : %s", m_dim, embedding.size(), m_path.c_str());
+            }
+            reset(static_cast<uint32_t>(embedding.size()));
+        }
+
+        std::vector<uint8_t> record(recordSize());
+        const uint64_t sum = checksum(key, embedding.data(), m_dim);
+        std::memcpy(record.data(), &key.content, sizeof(uint64_t));
+        std::memcpy(record.data() + 8, &key.config, sizeof(uint64_t));
+        std::memcpy(record.data() + 16, &key.model, sizeof(uint64_t));
+        std::memcpy(record.data() + 24, &sum, sizeof(uint64_t));
+        std::memcpy(record.data() + KEY_SIZE, embedding.data(), m_dim * sizeof(float));
+
+        const size_t offset = m_fileSize;
+        if (writeFully(m_fd, record.data(), record.size(), static_cast<off_t>(offset))) {
+            m_fileSize += record.size();
+            ++m_records;
+            m_index[key] = offset;
+        } else {
+            LOGE("Failed to append embedding record : %s (%s)", m_path.c_str(), std::strerror(errno));
+        }
+    } catch (...) {
+        unlockFile();
+        throw;
+    }
+    unlockFile();
+}
+
+size_t EmbeddingStore::size() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_index.size();
+}
@@ -0,0 +1,98 @@
+//
+// Created by glion on 2025-12-17.
+// 임베딩 저장소 - 고정 크기 레코드를 덧붙이기만 하는(append-only) 바이너리 파일 + 메모리 인덱스
+// 레코드 키는 (오디오 내용 해시, EmbeddingConfig 해시, 모델 해시) 이므로 모델 / 설정이 바뀌면 기존 레코드는 자동으로 적중하지 않음
+// 여러 프로세스가 같은 파일을 열 수 있음 - 덧붙이기 / 압축은 flock 배타 잠금, 다른 프로세스가 추가한 레코드는 미적중 시 따라잡음
+//
+// 파일 구조 (네이티브 엔디언)
+//  - 헤더 32바이트 : magic[8] "RSNEMB01", uint32 version, uint32 dim, uint8 reserved[16]
+//  - 레코드      : uint64 content, uint64 config, uint64 model, uint64 checksum, float embedding[dim]
+//
+
+#ifndef NDK_ESSENTIA_TEST_EMBEDDING_STORE_H
+#define NDK_ESSENTIA_TEST_EMBEDDING_STORE_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace NdkEssentiaEmbedding {
+
+    struct EmbeddingKey {
+        uint64_t content = 0;
+        uint64_t config = 0;
+        uint64_t model = 0;
+
+        bool operator==(const EmbeddingKey& other) const {
+            return content == other.content && config == other.config && model == other.model;
+        }
+    };
+
+    struct EmbeddingKeyHash {
+        size_t operator()(const EmbeddingKey& key) const {
+            uint64_t h = key.content;
+            h ^= key.config + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+            h ^= key.model + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+            return static_cast<size_t>(h);
+        }
+    };
+
+    class EmbeddingStore {
+    public:
+        // 파일을 열어(없으면 생성) 전체 레코드를 인덱싱. 실패 시 std::runtime_error
+        // 유효 레코드(같은 키의 최신 레코드, currentModel 이 0 이 아니면 그 모델의 레코드만)가 절반 미만이면 열 때 압축
+        explicit EmbeddingStore(const std::string& path, uint64_t currentModel = 0);
+        ~EmbeddingStore();
+
+        EmbeddingStore(const EmbeddingStore&) = delete;
+        EmbeddingStore& operator=(const EmbeddingStore&) = delete;
+
+        // 같은 경로의 저장소는 프로세스 전체에서 1개만 열어 공유 (currentModel 은 처음 연 쪽 기준)
+        static std::shared_ptr<EmbeddingStore> shared(const std::string& path, uint64_t currentModel = 0);
+
+        // 모델 파일별 기본 저장소 경로 (<modelPath>.store). 모델을 교체하면 이전 모델 레코드는 다음 열기에서 압축으로 제거
+        static std::string defaultPath(const std::string& modelPath);
+
+        // 적중 시 out 에 복사하고 true (레코드는 pread 로 읽음)
+        bool lookup(const EmbeddingKey& key, std::vector<float>& out);
+
+        // 레코드 추가 (같은 키가 있으면 새 레코드가 우선). 임베딩 차원이 저장소와 다르면 저장소를 비우고 새 차원으로 시작
+        void append(const EmbeddingKey& key, const std::vector<float>& embedding);
+
+        size_t size();
+
+    private:
+        static constexpr size_t HEADER_SIZE = 32;
+        static constexpr size_t KEY_SIZE = 4 * sizeof(uint64_t);
+        // 이보다 작은 파일은 압축하지 않음 (레코드 수)
+        static constexpr size_t COMPACT_MIN_RECORDS = 64;
+
+        size_t recordSize() const { return KEY_SIZE + m_dim * sizeof(float); }
+        static uint64_t checksum(const EmbeddingKey& key, const float* embedding, size_t dim);
+
+        void openFile();
+        // m_fd 에 flock(op). 다른 프로세스의 압축으로 경로가 새 파일을 가리키면 다시 열고 인덱스를 처음부터 구성
+        void lockFile(int op);
+        void unlockFile();
+        // 파일 변경(다른 프로세스의 추가 / 초기화) 반영. exclusive 이면 깨진 꼬리 레코드를 잘라냄 (잠금을 가진 상태에서 호출)
+        void sync(bool exclusive);
+        void clearIndex(uint32_t dim);
+        void compactIfSparse();
+        void reset(uint32_t dim);
+
+        std::string m_path;
+        uint64_t m_currentModel;
+        int m_fd = -1;
+        uint32_t m_dim = 0;
+        size_t m_fileSize = 0; // 인덱싱한 위치 (유효 레코드 끝)
+        size_t m_records = 0;  // 파일의 전체 레코드 수 (덮어쓰인 레코드 포함)
+
+        std::unordered_map<EmbeddingKey, size_t, EmbeddingKeyHash> m_index; // 키 -> 레코드 오프셋
+        std::mutex m_mutex;
+    };
+}
+
+#endif //NDK_ESSENTIA_TEST_EMBEDDING_STORE_H
@@ -0,0 +1,221 @@
+//
+// Created by glion on 2025-12-18.
+// FeatureCache 구현
+//
+
+#include "cache/feature_cache.h"
+#include "common/hash_util.h"
+#include "common/cal_runtime.h"
+#include "onnx/inference_batch.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <onnxruntime_cxx_api.h>
+
+using namespace NdkEssentiaEmbedding;
+
+namespace {
+    constexpr char CACHE_MAGIC[8] = {'R', 'S', 'N', 'F', 'E', 'A', '0', '1'};
+    constexpr uint32_t CACHE_VERSION = 1;
+
+    size_t alignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    // 헤더 이후 구간 배치 (mel, chroma, tempo 순, 각 구간 정렬)
+    struct SectionLayout {
+        size_t mel = 0;
+        size_t chroma = 0;
+        size_t tempo = 0;
+        size_t fileSize = 0;
+
+        SectionLayout(size_t headerSize, size_t alignment, size_t elementSize,
+                      size_t V, size_t M, size_t C, size_t T, size_t L) {
+            mel = headerSize;
+            chroma = alignUp(mel + V * M * T * elementSize, alignment);
+            tempo = alignUp(chroma + V * C * T * elementSize, alignment);
+            fileSize = tempo + V * L * elementSize;
+        }
+    };
+
+    // 텐서 행을 연속 구간 [rows][cols] 로 기록 (float32 는 그대로, float16 은 반정밀도로 변환)
+    void writeSection(const FeatureTensor& tensor, FeatureCache::Precision precision, uint8_t* dst) {
+        for (size_t r = 0; r < tensor.rows(); ++r) {
+            const float* row = tensor.row(r);
+            if (precision == FeatureCache::Precision::Float32) {
+                std::memcpy(dst, row, tensor.cols() * sizeof(float));
+                dst += tensor.cols() * sizeof(float);
+            } else {
+                auto* half = reinterpret_cast<uint16_t*>(dst);
+                for (size_t c = 0; c < tensor.cols(); ++c) {
+                    half[c] = Ort::Float16_t(row[c]).val;
+                }
+                dst += tensor.cols() * sizeof(uint16_t);
+            }
+        }
+    }
+
+    bool writeFile(const std::string& path, const std::vector<uint8_t>& bytes) {
+        FILE* file = std::fopen(path.c_str(), "wb");
+        if (file == nullptr) return false;
+        const bool ok = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+        return std::fclose(file) == 0 && ok;
+    }
+}
+
+FeatureCache::FeatureCache(const std::string& dir, Precision precision) : m_dir(dir), m_precision(precision) {
+    if (::mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+        throw std::runtime_error("Failed to create feature cache directory : " + dir + " (" + std::strerror(errno) + ")");
+    }
+}
+
+std::string FeatureCache::defaultDir(const std::string& modelPath) {
+    const size_t slash = modelPath.find_last_of('/');
+    const std::string dir = slash == std::string::npos ? "." : modelPath.substr(0, slash);
+    return dir + "/features";
+}
+
+std::string FeatureCache::pathFor(uint64_t content, uint64_t config) const {
+    return m_dir + "/" + Fnv1aHasher::toHex(content) + "-" + Fnv1aHasher::toHex(config) + ".feat";
+}
+
+bool FeatureCache::load(uint64_t content, uint64_t config, Entry& out) const {
+    const std::string path = pathFor(content, config);
+    if (!MappedFile::exists(path)) {
+        return false;
+    }
+
+    std::shared_ptr<MappedFile> file;
+    try {
+        file = std::make_shared<MappedFile>(path);
+    } catch (const std::exception& e) {
+        LOGW("Feature cache read failed : %s", e.what());
+        return false;
+    }
+
+    // 헤더 / 크기 검증 (저장은 rename 으로만 완료되므로 크기가 맞지 않으면 다른 버전이거나 손상된 파일)
+    uint32_t header[7] = {};
+    bool valid = file->size() >= HEADER_SIZE && std::memcmp(file->data(), CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0;
+    if (valid) {
+        std::memcpy(header, file->data() + sizeof(CACHE_MAGIC), sizeof(header));
+        valid = header[0] == CACHE_VERSION && header[1] <= static_cast<uint32_t>(Precision::Float16);
+    }
+    if (valid) {
+        out.m_precision = static_cast<Precision>(header[1]);
+        out.m_V = header[2];
+        out.m_M = header[3];
+        out.m_C = header[4];
+        out.m_T = header[5];
+        out.m_L = header[6];
+        const size_t elementSize = out.m_precision == Precision::Float32 ? sizeof(float) : sizeof(uint16_t);
+        const SectionLayout layout(HEADER_SIZE, SECTION_ALIGNMENT, elementSize,
+                                   out.m_V, out.m_M, out.m_C, out.m_T, out.m_L);
+        valid = out.m_V > 0 && layout.fileSize == file->size();
+        out.m_melOffset = layout.mel;
+        out.m_chromaOffset = layout.chroma;
+        out.m_tempoOffset = layout.tempo;
+    }
+    if (!valid) {
+        LOGW("Feature cache file is invalid, removing : %s", path.c_str());
+        ::unlink(path.c_str());
+        return false;
+    }
+
+    out.m_file = std::move(file);
+    return true;
+}
+
+bool FeatureCache::store(uint64_t content, uint64_t config, const std::vector<FullFeatures>& segments) const {
+    RunTimerLogger timer("FeatureCache store");
+
+    if (segments.empty()) {
+        return false;
+    }
+    const size_t V = segments.size();
+    const size_t M = segments.front().mel.rows();
+    const size_t C = segments.front().chroma.rows();
+    const size_t T = segments.front().mel.cols();
+    const size_t L = segments.front().tempo.cols();
+    for (const FullFeatures& features : segments) {
+        if (features.mel.rows() != M || features.mel.cols() != T || features.chroma.rows() != C ||
+            features.chroma.cols() != T || features.tempo.rows() != 1 || features.tempo.cols() != L) {
+            LOGW("Feature cache store skipped : segment shapes differ");
+            return false;
+        }
+    }
+
+    const size_t elementSize = m_precision == Precision::Float32 ? sizeof(float) : sizeof(uint16_t);
+    const SectionLayout layout(HEADER_SIZE, SECTION_ALIGNMENT, elementSize, V, M, C, T, L);
+
+    std::vector<uint8_t> bytes(layout.fileSize, 0);
+    const uint32_t header[7] = {
+            CACHE_VERSION, static_cast<uint32_t>(m_precision),
+            static_cast<uint32_t>(V), static_cast<uint32_t>(M), static_cast<uint32_t>(C),
+            static_cast<uint32_t>(T), static_cast<uint32_t>(L)
+    };
+    std::memcpy(bytes.data(), CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    std::memcpy(bytes.data() + sizeof(CACHE_MAGIC), header, sizeof(header));
+
+    for (size_t v = 0; v < V; ++v) {
+        writeSection(segments[v].mel, m_precision, bytes.data() + layout.mel + v * M * T * elementSize);
+        writeSection(segments[v].chroma, m_precision, bytes.data() + layout.chroma + v * C * T * elementSize);
+        writeSection(segments[v].tempo, m_precision, bytes.data() + layout.tempo + v * L * elementSize);
+    }
+
+    const std::string path = pathFor(content, config);
+    const std::string tmpPath = path + ".tmp" + std::to_string(::gettid());
+    if (!writeFile(tmpPath, bytes) || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        LOGW("Feature cache write failed : %s (%s)", path.c_str(), std::strerror(errno));
+        ::unlink(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+void FeatureCache::Entry::decodeHalf(size_t offset, size_t count, float* dst) const {
+    const auto* half = reinterpret_cast<const uint16_t*>(m_file->data() + offset);
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = Ort::Float16_t::FromBits(half[i]).ToFloat();
+    }
+}
+
+std::vector<FullFeatures> FeatureCache::Entry::segments() const {
+    std::vector<FullFeatures> segments(m_V);
+    for (size_t v = 0; v < m_V; ++v) {
+        FullFeatures& features = segments[v];
+        if (m_precision == Precision::Float32) {
+            features.mel = FeatureTensor::view(melData() + v * m_M * m_T, m_M, m_T, m_T);
+            features.chroma = FeatureTensor::view(chromaData() + v * m_C * m_T, m_C, m_T, m_T);
+            features.tempo = FeatureTensor::view(tempoData() + v * m_L, 1, m_L, m_L);
+        } else {
+            features.mel = FeatureTensor(m_M, m_T);
+            features.chroma = FeatureTensor(m_C, m_T);
+            features.tempo = FeatureTensor(1, m_L);
+            decodeHalf(m_melOffset + v * m_M * m_T * sizeof(uint16_t), m_M * m_T, features.mel.data());
+            decodeHalf(m_chromaOffset + v * m_C * m_T * sizeof(uint16_t), m_C * m_T, features.chroma.data());
+            decodeHalf(m_tempoOffset + v * m_L * sizeof(uint16_t), m_L, features.tempo.data());
+        }
+    }
+    return segments;
+}
+
+void FeatureCache::Entry::bindTo(InferenceBatch& batch) const {
+    if (m_precision == Precision::Float32) {
+        // 매핑(MAP_PRIVATE)을 입력 텐서로 직접 바인딩 - 배치가 매핑을 보관
+        batch.prepareExternal(m_V, m_M, m_C, m_T, m_L, melData(), chromaData(), tempoData(), m_file);
+        return;
+    }
+    batch.prepare(m_V, m_M, m_C, m_T, m_L);
+    for (size_t v = 0; v < m_V; ++v) {
+        FullFeatures slot = batch.slot(v);
+        decodeHalf(m_melOffset + v * m_M * m_T * sizeof(uint16_t), m_M * m_T, slot.mel.data());
+        decodeHalf(m_chromaOffset + v * m_C * m_T * sizeof(uint16_t), m_C * m_T, slot.chroma.data());
+        decodeHalf(m_tempoOffset + v * m_L * sizeof(uint16_t), m_L, slot.tempo.data());
+    }
+}
@@ -0,0 +1,88 @@
+//
+// Created by glion on 2025-12-18.
+// 세그먼트 특징 캐시 - 곡마다 [V,M,T] / [V,C,T] / [V,L] 입력 텐서를 ONNX 입력 레이아웃 그대로 파일 1개에 저장
+// 키는 (오디오 내용 해시, EmbeddingConfig 해시) 이므로 모델이 바뀌어도 적중 - 새 모델로 재인덱싱 시 디코딩 / 특징 추출 생략
+//
+// 파일 구조 (네이티브 엔디언, <dir>/<content>-<config>.feat)
+//  - 헤더 64바이트 : magic[8] "RSNFEA01", uint32 version, uint32 precision, uint32 V, M, C, T, L, uint8 reserved[28]
+//  - 본문        : mel [V][M][T], chroma [V][C][T], tempo [V][L] (각 구간 64바이트 정렬)
+// float32 파일은 매핑한 메모리를 그대로 세션 입력으로 바인딩 (복사 없음), float16 파일은 로드 시 float32 로 변환
+//
+
+#ifndef NDK_ESSENTIA_TEST_FEATURE_CACHE_H
+#define NDK_ESSENTIA_TEST_FEATURE_CACHE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "embedding_helper.h"
+#include "common/mapped_file.h"
+
+namespace NdkEssentiaEmbedding {
+
+    class FeatureCache {
+    public:
+        enum class Precision : uint32_t {
+            Float32 = 0, // 모델 입력과 같은 형식 - 매핑을 그대로 입력으로 사용
+            Float16 = 1, // 디스크 사용량 절반, 로드 시 변환 (값은 반정밀도로 반올림됨)
+        };
+
+        // 저장된 곡 1개의 특징 (매핑을 소유하므로 이 객체가 살아있는 동안 뷰 / 바인딩 유효)
+        class Entry {
+        public:
+            size_t batchSize() const { return m_V; }
+
+            // 세그먼트별 특징 - float32 이면 매핑을 가리키는 뷰, float16 이면 변환한 소유 텐서
+            std::vector<FullFeatures> segments() const;
+
+            // 추론 배치 입력으로 사용 - float32 이면 매핑을 그대로 바인딩, float16 이면 배치 버퍼에 변환
+            void bindTo(InferenceBatch& batch) const;
+
+        private:
+            friend class FeatureCache;
+
+            float* melData() const { return reinterpret_cast<float*>(m_file->data() + m_melOffset); }
+            float* chromaData() const { return reinterpret_cast<float*>(m_file->data() + m_chromaOffset); }
+            float* tempoData() const { return reinterpret_cast<float*>(m_file->data() + m_tempoOffset); }
+
+            // float16 구간 [offset, offset + count) 를 dst 로 변환
+            void decodeHalf(size_t offset, size_t count, float* dst) const;
+
+            std::shared_ptr<MappedFile> m_file;
+            Precision m_precision = Precision::Float32;
+            size_t m_V = 0;
+            size_t m_M = 0;
+            size_t m_C = 0;
+            size_t m_T = 0;
+            size_t m_L = 0;
+            size_t m_melOffset = 0;
+            size_t m_chromaOffset = 0;
+            size_t m_tempoOffset = 0;
+        };
+
+        // 디렉터리가 없으면 생성. 실패 시 std::runtime_error
+        FeatureCache(const std::string& dir, Precision precision = Precision::Float32);
+
+        // 모델 파일과 같은 디렉터리의 기본 캐시 디렉터리
+        static std::string defaultDir(const std::string& modelPath);
+
+        // 적중 시 out 에 매핑하고 true (파일이 깨졌으면 삭제하고 false)
+        bool load(uint64_t content, uint64_t config, Entry& out) const;
+
+        // 세그먼트 특징 저장 (임시 파일에 쓰고 rename 하므로 동시에 읽는 쪽은 완전한 파일만 봄)
+        bool store(uint64_t content, uint64_t config, const std::vector<FullFeatures>& segments) const;
+
+    private:
+        static constexpr size_t HEADER_SIZE = 64;
+        static constexpr size_t SECTION_ALIGNMENT = 64;
+
+        std::string pathFor(uint64_t content, uint64_t config) const;
+
+        std::string m_dir;
+        Precision m_precision;
+    };
+}
+
+#endif //NDK_ESSENTIA_TEST_FEATURE_CACHE_H
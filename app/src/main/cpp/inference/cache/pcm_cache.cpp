@@ -0,0 +1,281 @@
+//
+// Created by glion on 2025-12-19.
+// PcmCache 구현
+//
+
+#include "cache/pcm_cache.h"
+#include "common/hash_util.h"
+#include "common/cal_runtime.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <onnxruntime_cxx_api.h>
+
+using namespace NdkEssentiaEmbedding;
+
+namespace {
+    constexpr char CACHE_MAGIC[8] = {'R', 'S', 'N', 'P', 'C', 'M', '0', '1'};
+    constexpr uint32_t CACHE_VERSION = 4; // 4: 지문 규칙 변경 (전체 패킷 + 패킷 수 / 바이트 수)
+    constexpr float INT16_SCALE = 32767.0f;
+    constexpr const char* CACHE_EXTENSION = ".pcm";
+
+    int64_t nowNs() {
+        timespec ts{};
+        clock_gettime(CLOCK_REALTIME, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+    }
+
+    bool endsWith(const std::string& text, const char* suffix) {
+        const size_t len = std::strlen(suffix);
+        return text.size() >= len && text.compare(text.size() - len, len, suffix) == 0;
+    }
+
+    int16_t toInt16(float sample) {
+        return static_cast<int16_t>(std::lrintf(std::max(-1.0f, std::min(1.0f, sample)) * INT16_SCALE));
+    }
+}
+
+PcmCache::PcmCache(const std::string& dir, uint64_t budgetBytes, Format format, std::shared_ptr<ContentDigest> digest)
+        : m_dir(dir), m_budget(budgetBytes), m_format(format), m_digest(std::move(digest)) {
+    if (::mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+        throw std::runtime_error("Failed to create PCM cache directory : " + dir + " (" + std::strerror(errno) + ")");
+    }
+    scan();
+}
+
+std::shared_ptr<PcmCache> PcmCache::shared(const std::string& dir, uint64_t budgetBytes, Format format,
+                                           std::shared_ptr<ContentDigest> digest) {
+    static std::mutex mutex;
+    static std::map<std::string, std::weak_ptr<PcmCache>> caches;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_ptr<PcmCache> cache = caches[dir].lock();
+    if (!cache) {
+        cache = std::make_shared<PcmCache>(dir, budgetBytes, format, std::move(digest));
+        caches[dir] = cache;
+    }
+    return cache;
+}
+
+std::string PcmCache::defaultDir(const std::string& modelPath) {
+    const size_t slash = modelPath.find_last_of('/');
+    const std::string dir = slash == std::string::npos ? "." : modelPath.substr(0, slash);
+    return dir + "/pcm";
+}
+
+bool PcmCache::fileName(const AudioSource& source, int sampleRate, bool mono, std::string& name) const {
+    uint64_t content = 0;
+    const bool hashed = m_digest ? m_digest->hash(source, content) : hashAudioContent(source, content);
+    if (!hashed) {
+        return false;
+    }
+    name = Fnv1aHasher::toHex(content) + "-" + std::to_string(sampleRate) + (mono ? "-1" : "-0") + CACHE_EXTENSION;
+    return true;
+}
+
+void PcmCache::scan() {
+    RunTimerLogger timer("PcmCache scan");
+
+    DIR* dp = opendir(m_dir.c_str());
+    if (dp == nullptr) {
+        return;
+    }
+    while (dirent* entry = readdir(dp)) {
+        const std::string name = entry->d_name;
+        const std::string path = m_dir + "/" + name;
+        if (name.find(".tmp") != std::string::npos) {
+            ::unlink(path.c_str()); // 중단된 저장의 임시 파일
+            continue;
+        }
+        struct stat st{};
+        if (!endsWith(name, CACHE_EXTENSION) || ::stat(path.c_str(), &st) != 0) {
+            continue;
+        }
+        FileInfo info;
+        info.size = static_cast<uint64_t>(st.st_size);
+        info.lastUse = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+        m_files[name] = info;
+        m_usage += info.size;
+    }
+    closedir(dp);
+
+    // 예산이 줄어든 경우 바로 맞춤
+    evict(0);
+    LOGI("PCM cache opened : %zu files, %llu bytes %s", m_files.size(),
+         static_cast<unsigned long long>(m_usage), m_dir.c_str());
+}
+
+void PcmCache::remove(const std::string& name) {
+    auto it = m_files.find(name);
+    if (it == m_files.end()) return;
+    ::unlink((m_dir + "/" + name).c_str());
+    m_usage -= it->second.size;
+    m_files.erase(it);
+}
+
+void PcmCache::evict(uint64_t incoming) {
+    while (!m_files.empty() && m_usage + incoming > m_budget) {
+        auto oldest = std::min_element(m_files.begin(), m_files.end(), [](const auto& a, const auto& b) {
+            return a.second.lastUse < b.second.lastUse;
+        });
+        LOGD("PCM cache evict : %s", oldest->first.c_str());
+        remove(oldest->first);
+    }
+}
+
+bool PcmCache::load(const AudioSource& source, int sampleRate, bool mono, Entry& out) {
+    std::string name;
+    if (!fileName(source, sampleRate, mono, name)) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_files.find(name);
+    if (it == m_files.end()) {
+        return false;
+    }
+    const std::string path = m_dir + "/" + name;
+
+    MappedFile file;
+    try {
+        file = MappedFile(path);
+    } catch (const std::exception& e) {
+        LOGW("PCM cache read failed : %s", e.what());
+        remove(name);
+        return false;
+    }
+
+    // 헤더 / 크기 검증 (저장은 rename 으로만 완료되므로 크기가 맞지 않으면 다른 버전이거나 손상된 파일)
+    uint32_t header[4] = {};
+    uint64_t count = 0;
+    uint64_t fingerprint[2] = {};
+    bool valid = file.size() >= HEADER_SIZE && std::memcmp(file.data(), CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0;
+    if (valid) {
+        std::memcpy(header, file.data() + sizeof(CACHE_MAGIC), sizeof(header));
+        std::memcpy(&count, file.data() + sizeof(CACHE_MAGIC) + sizeof(header), sizeof(count));
+        std::memcpy(fingerprint, file.data() + sizeof(CACHE_MAGIC) + sizeof(header) + sizeof(count), sizeof(fingerprint));
+        valid = header[0] == CACHE_VERSION && header[1] <= static_cast<uint32_t>(Format::Float16)
+                && static_cast<int>(header[2]) == sampleRate && header[3] > 0
+                && file.size() == HEADER_SIZE + count * sizeof(uint16_t);
+    }
+    if (!valid) {
+        LOGW("PCM cache file is invalid, removing : %s", path.c_str());
+        remove(name);
+        return false;
+    }
+
+    out.m_file = std::move(file);
+    out.m_format = static_cast<Format>(header[1]);
+    out.m_sampleRate = static_cast<int>(header[2]);
+    out.m_channels = static_cast<int>(header[3]);
+    out.m_count = static_cast<size_t>(count);
+    out.m_fingerprint.packets = fingerprint[0];
+    out.m_fingerprint.perceptual = fingerprint[1];
+
+    // LRU 순서 갱신 (다음 프로세스에서도 유지되도록 mtime 에 기록)
+    it->second.lastUse = nowNs();
+    ::utimensat(AT_FDCWD, path.c_str(), nullptr, 0);
+    return true;
+}
+
+void PcmCache::store(
+        const AudioSource& source,
+        int sampleRate,
+        bool mono,
+        int channels,
+        const AudioFingerprint& fingerprint,
+        std::vector<float>& samples
+) {
+    RunTimerLogger timer("PcmCache store");
+
+    std::string name;
+    if (samples.empty() || !fileName(source, sampleRate, mono, name)) {
+        return;
+    }
+
+    // 저장 형식으로 반올림 (이후 적중 시 변환 결과와 동일하도록 samples 도 같은 값으로 교체)
+    const uint64_t fileSize = HEADER_SIZE + samples.size() * sizeof(uint16_t);
+    std::vector<uint8_t> bytes(fileSize, 0);
+    auto* body = reinterpret_cast<uint16_t*>(bytes.data() + HEADER_SIZE);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        if (m_format == Format::Int16) {
+            const int16_t q = toInt16(samples[i]);
+            std::memcpy(&body[i], &q, sizeof(q));
+            samples[i] = static_cast<float>(q) / INT16_SCALE;
+        } else {
+            const Ort::Float16_t h(samples[i]);
+            body[i] = h.val;
+            samples[i] = h.ToFloat();
+        }
+    }
+
+    const uint32_t header[4] = {
+            CACHE_VERSION, static_cast<uint32_t>(m_format),
+            static_cast<uint32_t>(sampleRate), static_cast<uint32_t>(channels)
+    };
+    const uint64_t count = samples.size();
+    std::memcpy(bytes.data(), CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    std::memcpy(bytes.data() + sizeof(CACHE_MAGIC), header, sizeof(header));
+    const uint64_t fingerprintWords[2] = {fingerprint.packets, fingerprint.perceptual};
+    std::memcpy(bytes.data() + sizeof(CACHE_MAGIC) + sizeof(header), &count, sizeof(count));
+    std::memcpy(bytes.data() + sizeof(CACHE_MAGIC) + sizeof(header) + sizeof(count),
+                fingerprintWords, sizeof(fingerprintWords));
+
+    if (fileSize > m_budget) {
+        LOGD("PCM cache store skipped : %llu bytes exceeds budget", static_cast<unsigned long long>(fileSize));
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    remove(name);
+    evict(fileSize);
+
+    const std::string path = m_dir + "/" + name;
+    const std::string tmpPath = path + ".tmp" + std::to_string(::gettid());
+    FILE* file = std::fopen(tmpPath.c_str(), "wb");
+    bool ok = file != nullptr;
+    if (ok) {
+        ok = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+        ok = std::fclose(file) == 0 && ok;
+    }
+    if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        LOGW("PCM cache write failed : %s (%s)", path.c_str(), std::strerror(errno));
+        ::unlink(tmpPath.c_str());
+        return;
+    }
+
+    FileInfo info;
+    info.size = fileSize;
+    info.lastUse = nowNs();
+    m_files[name] = info;
+    m_usage += fileSize;
+}
+
+uint64_t PcmCache::diskUsage() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_usage;
+}
+
+void PcmCache::Entry::toFloat(size_t offset, size_t count, float* dst) const {
+    const auto* body = reinterpret_cast<const uint16_t*>(m_file.data() + HEADER_SIZE) + offset;
+    if (m_format == Format::Int16) {
+        const auto* q = reinterpret_cast<const int16_t*>(body);
+        for (size_t i = 0; i < count; ++i) {
+            dst[i] = static_cast<float>(q[i]) / INT16_SCALE;
+        }
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            dst[i] = Ort::Float16_t::FromBits(body[i]).ToFloat();
+        }
+    }
+}
@@ -0,0 +1,109 @@
+//
+// Created by glion on 2025-12-19.
+// 디코딩 PCM 캐시 - 리샘플링된 PCM 을 int16 / float16 으로 파일 1개에 저장하고 이후 로드는 FFmpeg 없이 매핑에서 변환
+// 키는 (오디오 내용 해시, 목표 샘플레이트, 모노 여부). 디스크 예산을 넘으면 가장 오래 사용하지 않은 파일부터 삭제(LRU)
+//
+// 파일 구조 (네이티브 엔디언, <dir>/<content>-<sr>-<mono>.pcm)
+//  - 헤더 64바이트 : magic[8] "RSNPCM01", uint32 version, uint32 format, uint32 sampleRate, uint32 channels,
+//                    uint64 sampleCount, uint64 packetFingerprint, uint64 perceptualFingerprint, uint8 reserved[16]
+//  - 본문        : 인터리브 샘플 [sampleCount] (int16 또는 float16)
+//
+
+#ifndef NDK_ESSENTIA_TEST_PCM_CACHE_H
+#define NDK_ESSENTIA_TEST_PCM_CACHE_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/mapped_file.h"
+#include "common/audio_data.h"
+#include "common/audio_source.h"
+#include "cache/content_digest.h"
+
+namespace NdkEssentiaEmbedding {
+
+    class PcmCache {
+    public:
+        enum class Format : uint32_t {
+            Int16 = 0,   // [-1, 1] 균일 양자화 (약 -96 dB)
+            Float16 = 1, // 작은 진폭에서 정밀도 유지
+        };
+
+        // 저장된 곡 1개의 PCM 매핑
+        class Entry {
+        public:
+            int sampleRate() const { return m_sampleRate; }
+            int channels() const { return m_channels; }
+            size_t size() const { return m_count; }
+
+            // 저장 시점의 디코딩 지문 (적중 시에는 패킷을 읽지 않으므로 저장된 값 사용)
+            const AudioFingerprint& fingerprint() const { return m_fingerprint; }
+
+            // 샘플 [offset, offset + count) 를 float32 로 변환하여 dst 에 기록
+            void toFloat(size_t offset, size_t count, float* dst) const;
+
+        private:
+            friend class PcmCache;
+
+            MappedFile m_file;
+            Format m_format = Format::Int16;
+            int m_sampleRate = 0;
+            int m_channels = 0;
+            size_t m_count = 0;
+            AudioFingerprint m_fingerprint;
+        };
+
+        // 디렉터리가 없으면 생성하고 기존 파일을 인덱싱. 실패 시 std::runtime_error
+        // digest 가 있으면 내용 키를 영속된 해시로 조회 (없으면 조회마다 파일 전체 해시)
+        PcmCache(const std::string& dir, uint64_t budgetBytes, Format format = Format::Int16,
+                 std::shared_ptr<ContentDigest> digest = nullptr);
+
+        PcmCache(const PcmCache&) = delete;
+        PcmCache& operator=(const PcmCache&) = delete;
+
+        // 같은 디렉터리의 캐시는 프로세스 전체에서 1개만 열어 공유 (예산 / 형식 / digest 는 처음 연 쪽 기준)
+        static std::shared_ptr<PcmCache> shared(const std::string& dir, uint64_t budgetBytes, Format format = Format::Int16,
+                                                std::shared_ptr<ContentDigest> digest = nullptr);
+
+        // 모델 파일과 같은 디렉터리의 기본 캐시 디렉터리
+        static std::string defaultDir(const std::string& modelPath);
+
+        // 적중 시 out 에 매핑하고 true (사용 시각 갱신). 키는 source 내용 해시이므로 경로 / fd / 메모리 입력이 같은 바이트면 같은 항목
+        bool load(const AudioSource& source, int sampleRate, bool mono, Entry& out);
+
+        // PCM 저장 후 예산을 넘으면 오래된 파일부터 삭제
+        // samples 는 저장 형식으로 반올림되어 돌아오므로 적중 / 미적중 결과가 같음
+        void store(const AudioSource& source, int sampleRate, bool mono, int channels,
+                   const AudioFingerprint& fingerprint, std::vector<float>& samples);
+
+        uint64_t diskUsage();
+
+    private:
+        static constexpr size_t HEADER_SIZE = 64;
+
+        struct FileInfo {
+            uint64_t size = 0;
+            int64_t lastUse = 0; // 마지막 사용 시각 (ns, 파일 mtime 으로 영속)
+        };
+
+        bool fileName(const AudioSource& source, int sampleRate, bool mono, std::string& name) const;
+        void scan();
+        void evict(uint64_t incoming);
+        void remove(const std::string& name);
+
+        std::string m_dir;
+        uint64_t m_budget;
+        Format m_format;
+        std::shared_ptr<ContentDigest> m_digest;
+
+        std::map<std::string, FileInfo> m_files; // 파일 이름 -> 크기 / 사용 시각
+        uint64_t m_usage = 0;
+        std::mutex m_mutex;
+    };
+}
+
+#endif //NDK_ESSENTIA_TEST_PCM_CACHE_H
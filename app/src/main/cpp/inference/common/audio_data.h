@@ -6,8 +6,24 @@
 #ifndef NDK_ESSENTIA_TEST_DATA_H
 #define NDK_ESSENTIA_TEST_DATA_H
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
+/**
+ * 디코딩 중에 계산되는 오디오 내용 지문
+ */
+struct AudioFingerprint {
+    // 오디오 스트림 전체 압축 패킷(+ 코덱 파라미터, 패킷 수 / 바이트 수) 해시 - 파일 이름 / 경로 / 태그와 무관 (0 이면 없음)
+    // 전체 / 구간 디코딩, PCM 캐시 어느 경로로 읽어도 같은 패킷 집합이므로 같은 값
+    uint64_t packets = 0;
+
+    // 디코딩 PCM 앞부분(PERCEPTUAL_WINDOW_FRAMES)의 지각 지문 (perceptualFingerprint, 근사 중복 판단용 - 캐시 키로는 사용하지 않음)
+    uint64_t perceptual = 0;
+
+    bool valid() const { return packets != 0; }
+};
+
 /**
  * 로드된 오디오 데이터와 메타 정보를 담는 구조체
  */
@@ -21,8 +37,62 @@ struct AudioData {
     // 최종 채널 수 (모노: 1, 스테레오: 2)
     int numChannels = 0;
 
+    // 디코딩 중 계산한 내용 지문
+    AudioFingerprint fingerprint;
+
     // 기본 생성자
     AudioData() = default;
 };
 
+/**
+ * 다른 버퍼의 연속 구간을 가리키는 읽기 전용 오디오 뷰 (포인터 + 길이, 복사 없음)
+ * 가리키는 버퍼가 뷰보다 오래 살아있어야 함
+ */
+class AudioView {
+public:
+    AudioView() = default;
+    AudioView(const float* data, size_t size) : m_data(data), m_size(size) {}
+    // std::vector<float> 전체를 가리키는 뷰 (암시적 변환 허용)
+    AudioView(const std::vector<float>& samples) : m_data(samples.data()), m_size(samples.size()) {}
+
+    const float* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    const float* begin() const { return m_data; }
+    const float* end() const { return m_data + m_size; }
+    const float& operator[](size_t i) const { return m_data[i]; }
+
+    // [offset, offset + count) 부분 뷰
+    AudioView subView(size_t offset, size_t count) const { return AudioView(m_data + offset, count); }
+
+private:
+    const float* m_data = nullptr;
+    size_t m_size = 0;
+};
+
+/**
+ * 세그먼트 뷰와 뷰가 가리키는 PCM 버퍼를 함께 보관
+ * (복사하면 뷰가 원래 버퍼를 가리키게 되므로 이동만 허용. vector 이동은 내부 버퍼 주소를 유지)
+ */
+struct SegmentedAudio {
+    // 디코딩된 PCM (전체 디코딩 1개 또는 구간 디코딩 범위별)
+    std::vector<std::vector<float>> buffers;
+
+    // buffers 안을 가리키는 세그먼트 뷰
+    std::vector<AudioView> segments;
+
+    // 디코딩 중 계산한 내용 지문
+    AudioFingerprint fingerprint;
+
+    SegmentedAudio() = default;
+    SegmentedAudio(SegmentedAudio&&) = default;
+    SegmentedAudio& operator=(SegmentedAudio&&) = default;
+    SegmentedAudio(const SegmentedAudio&) = delete;
+    SegmentedAudio& operator=(const SegmentedAudio&) = delete;
+
+    bool empty() const { return segments.empty(); }
+    size_t size() const { return segments.size(); }
+};
+
 #endif //NDK_ESSENTIA_TEST_DATA_H
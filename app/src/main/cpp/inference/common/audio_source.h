@@ -0,0 +1,103 @@
+//
+// Created by glion on 2025-12-21.
+// 오디오 입력 소스 - 파일 경로, 파일 디스크립터 구간 (fd, offset, length), 메모리 버퍼
+// fd / 메모리 입력은 FFmpeg 사용자 정의 AVIOContext 로 그 자리에서 읽으므로 임시 파일 복사가 필요 없음
+// (APK 에셋의 AssetFileDescriptor, 다운로드한 바이트 등)
+//
+
+#ifndef NDK_ESSENTIA_TEST_AUDIO_SOURCE_H
+#define NDK_ESSENTIA_TEST_AUDIO_SOURCE_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace NdkEssentiaEmbedding {
+
+    class AudioSource {
+    public:
+        enum class Kind { Path, Fd, Memory };
+
+        // 파일 경로 (암시적 변환 허용 - 기존 경로 기반 호출 그대로 사용)
+        AudioSource(const std::string& path) : m_kind(Kind::Path), m_path(path) {}
+        AudioSource(const char* path) : m_kind(Kind::Path), m_path(path) {}
+
+        // fd 의 [offset, offset + length) 구간. length < 0 이면 파일 끝까지
+        // fd 는 소유하지 않으므로 호출자가 디코딩이 끝날 때까지 열어두어야 함 (pread 만 사용하므로 파일 위치는 변경되지 않음)
+        static AudioSource fromFd(int fd, int64_t offset, int64_t length = -1) {
+            AudioSource source(Kind::Fd);
+            source.m_fd = fd;
+            source.m_offset = std::max<int64_t>(0, offset);
+            if (length < 0) {
+                struct stat st{};
+                length = ::fstat(fd, &st) == 0 ? std::max<int64_t>(0, st.st_size - source.m_offset) : 0;
+            }
+            source.m_size = length;
+            return source;
+        }
+
+        // 메모리 버퍼 [data, data + size). 버퍼는 디코딩이 끝날 때까지 유지되어야 함
+        static AudioSource fromMemory(const void* data, size_t size) {
+            AudioSource source(Kind::Memory);
+            source.m_data = static_cast<const uint8_t*>(data);
+            source.m_size = static_cast<int64_t>(size);
+            return source;
+        }
+
+        Kind kind() const { return m_kind; }
+        bool isPath() const { return m_kind == Kind::Path; }
+        const std::string& path() const { return m_path; }
+
+        // fd 입력의 파일 디스크립터 / 구간 시작 위치 (다른 입력은 -1 / 0)
+        int fd() const { return m_fd; }
+        int64_t offset() const { return m_offset; }
+
+        // fd / 메모리 입력의 바이트 수 (경로 입력은 -1)
+        int64_t size() const { return m_kind == Kind::Path ? -1 : m_size; }
+
+        // fd / 메모리 입력의 [position, position + count) 읽기. 반환: 읽은 바이트 수 (끝이면 0, 실패 시 -1)
+        int64_t readAt(int64_t position, void* dst, size_t count) const {
+            if (m_kind == Kind::Path || position < 0) return -1;
+            if (position >= m_size) return 0;
+            const size_t available = static_cast<size_t>(std::min<int64_t>(static_cast<int64_t>(count), m_size - position));
+            if (m_kind == Kind::Memory) {
+                std::memcpy(dst, m_data + position, available);
+                return static_cast<int64_t>(available);
+            }
+            ssize_t read;
+            do {
+                read = ::pread(m_fd, dst, available, static_cast<off_t>(m_offset + position));
+            } while (read < 0 && errno == EINTR);
+            return read;
+        }
+
+        // 로그용 설명
+        std::string describe() const {
+            switch (m_kind) {
+                case Kind::Fd:
+                    return "fd:" + std::to_string(m_fd) + "@" + std::to_string(m_offset) + "+" + std::to_string(m_size);
+                case Kind::Memory:
+                    return "memory:" + std::to_string(m_size);
+                default:
+                    return m_path;
+            }
+        }
+
+    private:
+        explicit AudioSource(Kind kind) : m_kind(kind) {}
+
+        Kind m_kind;
+        std::string m_path;
+        int m_fd = -1;
+        int64_t m_offset = 0;
+        int64_t m_size = 0;
+        const uint8_t* m_data = nullptr;
+    };
+}
+
+#endif //NDK_ESSENTIA_TEST_AUDIO_SOURCE_H
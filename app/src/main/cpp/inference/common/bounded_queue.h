@@ -0,0 +1,78 @@
+//
+// Created by glion on 2025-12-16.
+// 고정 용량 블로킹 큐 - 파이프라인 단계 사이의 배압(backpressure)용. 메모리 사용량이 큐 깊이로 제한됨
+//
+
+#ifndef NDK_ESSENTIA_TEST_BOUNDED_QUEUE_H
+#define NDK_ESSENTIA_TEST_BOUNDED_QUEUE_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace NdkEssentiaEmbedding {
+
+    template <typename T>
+    class BoundedQueue {
+    public:
+        explicit BoundedQueue(size_t capacity) : m_capacity(std::max<size_t>(1, capacity)) {}
+
+        BoundedQueue(const BoundedQueue&) = delete;
+        BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+        // 가득 차 있으면 자리가 날 때까지 대기. 닫힌 큐면 false (item 은 버려짐)
+        bool push(T item) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_notFull.wait(lock, [this]() { return m_closed || m_items.size() < m_capacity; });
+            if (m_closed) return false;
+            m_items.push_back(std::move(item));
+            lock.unlock();
+            m_notEmpty.notify_one();
+            return true;
+        }
+
+        // 비어 있으면 대기. 닫힌 뒤 남은 항목을 모두 꺼냈으면 false
+        bool pop(T& out) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_notEmpty.wait(lock, [this]() { return !m_items.empty() || m_closed; });
+            if (m_items.empty()) return false;
+            out = std::move(m_items.front());
+            m_items.pop_front();
+            lock.unlock();
+            m_notFull.notify_one();
+            return true;
+        }
+
+        // 더 이상 push 받지 않음 (이미 들어간 항목은 pop 으로 꺼낼 수 있음)
+        void close() {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_closed = true;
+            }
+            m_notFull.notify_all();
+            m_notEmpty.notify_all();
+        }
+
+        // 닫고 남은 항목도 버림 (취소용)
+        void abort() {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_closed = true;
+                m_items.clear();
+            }
+            m_notFull.notify_all();
+            m_notEmpty.notify_all();
+        }
+
+    private:
+        const size_t m_capacity;
+        std::deque<T> m_items;
+        bool m_closed = false;
+        std::mutex m_mutex;
+        std::condition_variable m_notFull;
+        std::condition_variable m_notEmpty;
+    };
+}
+
+#endif //NDK_ESSENTIA_TEST_BOUNDED_QUEUE_H
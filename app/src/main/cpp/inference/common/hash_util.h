@@ -0,0 +1,153 @@
+//
+// Created by glion on 2025-12-12.
+// 해시 유틸리티 - 파일 / 버퍼 내용 기반 64bit FNV-1a 해시 (캐시 키 생성용, 암호학적 용도 아님)
+//
+
+#ifndef NDK_ESSENTIA_TEST_HASH_UTIL_H
+#define NDK_ESSENTIA_TEST_HASH_UTIL_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "struct/embedding_config.h"
+#include "common/audio_source.h"
+
+namespace NdkEssentiaEmbedding {
+
+    class Fnv1aHasher {
+    public:
+        static constexpr uint64_t OFFSET_BASIS = 14695981039346656037ull;
+        static constexpr uint64_t PRIME = 1099511628211ull;
+
+        void update(const void* data, size_t size) {
+            const auto* bytes = static_cast<const uint8_t*>(data);
+            uint64_t h = m_hash;
+            for (size_t i = 0; i < size; ++i) {
+                h ^= bytes[i];
+                h *= PRIME;
+            }
+            m_hash = h;
+        }
+
+        void update(const std::string& text) { update(text.data(), text.size()); }
+
+        // 파일 전체 내용을 누적. 파일을 열 수 없으면 false (해시는 변경되지 않음)
+        bool updateFile(const std::string& path) {
+            FILE* file = std::fopen(path.c_str(), "rb");
+            if (file == nullptr) return false;
+            std::vector<uint8_t> chunk(1 << 20);
+            size_t read;
+            while ((read = std::fread(chunk.data(), 1, chunk.size(), file)) > 0) {
+                update(chunk.data(), read);
+            }
+            std::fclose(file);
+            return true;
+        }
+
+        // 입력 전체 내용 + 바이트 수 누적 (경로 / fd / 메모리 입력이 같은 바이트면 같은 해시). 읽을 수 없으면 false
+        bool updateSource(const AudioSource& source) {
+            std::vector<uint8_t> chunk(1 << 20);
+            int64_t total = 0;
+            if (source.isPath()) {
+                FILE* file = std::fopen(source.path().c_str(), "rb");
+                if (file == nullptr) return false;
+                size_t read;
+                while ((read = std::fread(chunk.data(), 1, chunk.size(), file)) > 0) {
+                    update(chunk.data(), read);
+                    total += static_cast<int64_t>(read);
+                }
+                const bool ok = std::ferror(file) == 0;
+                std::fclose(file);
+                if (!ok) return false;
+            } else {
+                int64_t read;
+                while ((read = source.readAt(total, chunk.data(), chunk.size())) > 0) {
+                    update(chunk.data(), static_cast<size_t>(read));
+                    total += read;
+                }
+                if (read < 0) return false;
+            }
+            update(&total, sizeof(total));
+            return true;
+        }
+
+        uint64_t value() const { return m_hash; }
+
+        // 16자리 소문자 16진수
+        std::string hex() const { return toHex(m_hash); }
+
+        static std::string toHex(uint64_t value) {
+            static const char digits[] = "0123456789abcdef";
+            std::string out(16, '0');
+            for (int i = 15; i >= 0; --i) {
+                out[i] = digits[value & 0xF];
+                value >>= 4;
+            }
+            return out;
+        }
+
+    private:
+        uint64_t m_hash = OFFSET_BASIS;
+    };
+
+    // 오디오 입력 전체 내용 해시 - 저장소 / 특징 캐시 / PCM 캐시의 내용 키
+    // 파일 전체를 읽으므로 반복 조회는 ContentDigest 의 (dev, inode, 크기, 수정 시각) 별 영속 값 사용
+    inline bool hashAudioContent(const AudioSource& source, uint64_t& hash) {
+        Fnv1aHasher hasher;
+        if (!hasher.updateSource(source)) return false;
+        hash = hasher.value();
+        return true;
+    }
+
+    // 특징 / 임베딩 결과에 영향을 주는 EmbeddingConfig 필드 해시 (decoder_threads 등 실행 설정은 제외)
+    // 필드를 추가하면 여기에도 추가해야 캐시가 무효화됨
+    inline uint64_t hashEmbeddingConfig(const EmbeddingConfig& config) {
+        Fnv1aHasher hasher;
+        auto add = [&hasher](const auto& value) { hasher.update(&value, sizeof(value)); };
+        add(config.sr);
+        add(config.isMono);
+        add(config.mel_n_mels);
+        add(config.mel_hop_ms);
+        add(config.chroma_bins);
+        add(config.tempo_win);
+        add(config.seg_seconds);
+        add(config.hop_seconds);
+        add(config.segments_per_song);
+        add(config.use_hpss);
+        add(config.segment_only_decode);
+        add(config.chroma_at_mel_hop);
+        add(config.onset_from_logmel);
+        return hasher.value();
+    }
+
+    // 지각 지문 구간 - 출력 타임라인 0 부터 65 블록 (디코딩 경로와 무관하게 항상 같은 샘플)
+    constexpr size_t PERCEPTUAL_BLOCK_FRAMES = 4096;
+    constexpr size_t PERCEPTUAL_WINDOW_FRAMES = 65 * PERCEPTUAL_BLOCK_FRAMES;
+
+    // 디코딩 PCM 의 가벼운 지각(perceptual) 지문 - 타임라인 0 부터 시작하는 samples 앞 65개 블록의 에너지 증감 부호 64bit
+    // 구간 전체가 없으면(짧은 곡, 앞부분을 디코딩하지 않은 경우) 0
+    // 재인코딩 / 음량 변화에도 대체로 유지되지만 충돌(무음으로 시작하는 곡 등)이 있으므로 단독 캐시 키로는 사용하지 않음
+    inline uint64_t perceptualFingerprint(const float* samples, size_t frames, int channels) {
+        if (samples == nullptr || channels <= 0 || frames < PERCEPTUAL_WINDOW_FRAMES) return 0;
+        double previous = -1.0;
+        uint64_t bits = 0;
+        size_t bit = 0;
+        for (size_t start = 0; start + PERCEPTUAL_BLOCK_FRAMES <= PERCEPTUAL_WINDOW_FRAMES; start += PERCEPTUAL_BLOCK_FRAMES) {
+            double energy = 0.0;
+            const float* block = samples + start * static_cast<size_t>(channels);
+            for (size_t i = 0; i < PERCEPTUAL_BLOCK_FRAMES * static_cast<size_t>(channels); ++i) {
+                energy += static_cast<double>(block[i]) * block[i];
+            }
+            if (previous >= 0.0) {
+                bits |= static_cast<uint64_t>(energy > previous) << bit;
+                ++bit;
+            }
+            previous = energy;
+        }
+        return bits;
+    }
+}
+
+#endif //NDK_ESSENTIA_TEST_HASH_UTIL_H
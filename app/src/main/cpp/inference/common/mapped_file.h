@@ -0,0 +1,93 @@
+//
+// Created by glion on 2025-12-13.
+// 읽기 전용 파일 메모리 매핑 (RAII) - 페이지 캐시를 그대로 공유하여 힙 복사 없이 파일 내용 사용
+//
+
+#ifndef NDK_ESSENTIA_TEST_MAPPED_FILE_H
+#define NDK_ESSENTIA_TEST_MAPPED_FILE_H
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace NdkEssentiaEmbedding {
+
+    class MappedFile {
+    public:
+        MappedFile() = default;
+
+        // 파일 전체를 매핑. 실패 시 std::runtime_error
+        // MAP_PRIVATE + PROT_WRITE: 쓰기가 일어난 페이지만 복사(copy-on-write)되고 원본 파일은 변경되지 않음
+        explicit MappedFile(const std::string& path) {
+            int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                throw std::runtime_error("Failed to open file for mmap : " + path + " (" + std::strerror(errno) + ")");
+            }
+
+            struct stat st{};
+            if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+                ::close(fd);
+                throw std::runtime_error("Failed to stat file for mmap : " + path);
+            }
+
+            void* addr = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            ::close(fd); // 매핑은 fd 를 닫아도 유지됨
+            if (addr == MAP_FAILED) {
+                throw std::runtime_error("Failed to mmap file : " + path + " (" + std::strerror(errno) + ")");
+            }
+
+            m_data = static_cast<char*>(addr);
+            m_size = static_cast<size_t>(st.st_size);
+        }
+
+        ~MappedFile() { reset(); }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept : m_data(other.m_data), m_size(other.m_size) {
+            other.m_data = nullptr;
+            other.m_size = 0;
+        }
+
+        MappedFile& operator=(MappedFile&& other) noexcept {
+            if (this != &other) {
+                reset();
+                m_data = other.m_data;
+                m_size = other.m_size;
+                other.m_data = nullptr;
+                other.m_size = 0;
+            }
+            return *this;
+        }
+
+        static bool exists(const std::string& path) {
+            struct stat st{};
+            return ::stat(path.c_str(), &st) == 0 && st.st_size > 0;
+        }
+
+        char* data() const { return m_data; }
+        size_t size() const { return m_size; }
+        bool valid() const { return m_data != nullptr; }
+
+        void reset() {
+            if (m_data != nullptr) {
+                ::munmap(m_data, m_size);
+                m_data = nullptr;
+                m_size = 0;
+            }
+        }
+
+    private:
+        char* m_data = nullptr;
+        size_t m_size = 0;
+    };
+}
+
+#endif //NDK_ESSENTIA_TEST_MAPPED_FILE_H
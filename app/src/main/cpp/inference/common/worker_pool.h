@@ -0,0 +1,173 @@
+//
+// Created by glion on 2025-12-04.
+// 특징 추출용 작업자 풀 - Eigen NonBlockingThreadPool(work-stealing) 기반
+//
+
+#ifndef NDK_ESSENTIA_TEST_WORKER_POOL_H
+#define NDK_ESSENTIA_TEST_WORKER_POOL_H
+
+#define EIGEN_USE_THREADS
+#include <unsupported/Eigen/CXX11/ThreadPool>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace NdkEssentiaEmbedding {
+
+    class WorkerPool {
+    public:
+        explicit WorkerPool(int numThreads) : m_pool(std::max(1, numThreads)) {}
+
+        int size() const { return m_pool.NumThreads(); }
+
+        void schedule(std::function<void()> fn) { m_pool.Schedule(std::move(fn)); }
+
+        // 0 이하이면 하드웨어 코어 수 사용
+        static int resolveThreadCount(int requested) {
+            if (requested > 0) return requested;
+            return std::max(1u, std::thread::hardware_concurrency());
+        }
+
+    private:
+        Eigen::ThreadPool m_pool;
+    };
+
+    /**
+     * @brief [0, count) 인덱스에 대해 fn 을 병렬 수행하고 모두 끝날 때까지 대기.
+     * 호출 스레드도 인덱스를 직접 가져가 처리하므로, 풀 작업자 안에서 중첩 호출해도 교착되지 않음.
+     * fn 에서 발생한 첫 번째 예외는 호출 스레드에서 다시 던짐.
+     * @param pool nullptr 이면 호출 스레드에서 순차 수행
+     */
+    inline void parallelFor(WorkerPool* pool, size_t count, const std::function<void(size_t)>& fn) {
+        if (pool == nullptr || count <= 1) {
+            for (size_t i = 0; i < count; ++i) fn(i);
+            return;
+        }
+
+        struct State {
+            std::atomic<size_t> next{0};
+            size_t done = 0;
+            std::exception_ptr error;
+            std::mutex mutex;
+            std::condition_variable cv;
+        };
+        auto state = std::make_shared<State>();
+        const size_t total = count;
+
+        // 인덱스를 하나씩 가져가며 처리 (이미 다른 스레드가 가져간 인덱스만 기다리게 됨)
+        auto drain = [state, total, &fn]() {
+            size_t i;
+            while ((i = state->next.fetch_add(1)) < total) {
+                try {
+                    fn(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    if (!state->error) state->error = std::current_exception();
+                }
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (++state->done == total) state->cv.notify_all();
+            }
+        };
+
+        const size_t helpers = std::min(static_cast<size_t>(pool->size()), total - 1);
+        for (size_t h = 0; h < helpers; ++h) {
+            pool->schedule(drain);
+        }
+        drain();
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->cv.wait(lock, [&]() { return state->done == total; });
+        if (state->error) std::rethrow_exception(state->error);
+    }
+
+    /**
+     * @brief 서로 독립적인 태스크 묶음 (작은 태스크 그래프 구성용).
+     * run() 으로 등록한 태스크는 풀에 바로 예약되고, wait() 은 아직 어떤 작업자도 가져가지 않은 태스크를
+     * 호출 스레드에서 직접 수행한 뒤 나머지의 완료를 기다림 (풀 작업자 안에서 사용해도 교착되지 않음).
+     * 의존 관계는 "선행 태스크를 호출 스레드에서 수행한 뒤 후행 태스크를 run" 하는 방식으로 표현.
+     */
+    class TaskGroup {
+    public:
+        // pool 이 nullptr 이면 run() 시점에 호출 스레드에서 바로 수행
+        explicit TaskGroup(WorkerPool* pool) : m_pool(pool), m_state(std::make_shared<State>()) {}
+
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        ~TaskGroup() {
+            // 예외 등으로 wait() 없이 빠져나가는 경우에도 참조 캡처한 태스크가 끝나기 전에 소멸되지 않도록 대기
+            try { wait(); } catch (...) {}
+        }
+
+        void run(std::function<void()> fn) {
+            auto task = std::make_shared<Task>();
+            task->fn = std::move(fn);
+            if (m_pool == nullptr) {
+                execute(m_state, task);
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_state->mutex);
+                ++m_state->pending;
+            }
+            m_tasks.push_back(task);
+            auto state = m_state;
+            m_pool->schedule([state, task]() { execute(state, task); });
+        }
+
+        // 모든 태스크 완료 대기. 태스크에서 발생한 첫 번째 예외를 다시 던짐
+        void wait() {
+            for (auto& task : m_tasks) {
+                execute(m_state, task);
+            }
+            m_tasks.clear();
+
+            std::unique_lock<std::mutex> lock(m_state->mutex);
+            m_state->cv.wait(lock, [this]() { return m_state->pending == 0; });
+            if (m_state->error) {
+                std::exception_ptr error = m_state->error;
+                m_state->error = nullptr;
+                std::rethrow_exception(error);
+            }
+        }
+
+    private:
+        struct Task {
+            std::atomic<bool> claimed{false};
+            std::function<void()> fn;
+        };
+        struct State {
+            size_t pending = 0;
+            std::exception_ptr error;
+            std::mutex mutex;
+            std::condition_variable cv;
+        };
+
+        // 태스크를 먼저 가져간(claim) 스레드만 수행
+        static void execute(const std::shared_ptr<State>& state, const std::shared_ptr<Task>& task) {
+            if (task->claimed.exchange(true)) return;
+            try {
+                task->fn();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (!state->error) state->error = std::current_exception();
+            }
+            task->fn = nullptr;
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (state->pending > 0 && --state->pending == 0) state->cv.notify_all();
+        }
+
+        WorkerPool* m_pool;
+        std::shared_ptr<State> m_state;
+        std::vector<std::shared_ptr<Task>> m_tasks;
+    };
+}
+
+#endif //NDK_ESSENTIA_TEST_WORKER_POOL_H
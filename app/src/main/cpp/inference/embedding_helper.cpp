@@ -6,7 +6,18 @@
 #include "embedding_helper.h"
 #include <pool.h>
 #include <essentia.h>
+#include <onnxruntime_session_options_config_keys.h>
+#include "common/hash_util.h"
+#include "common/mapped_file.h"
 #include <cmath>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 
 using namespace essentia;
@@ -19,26 +30,259 @@ EmbeddingHelper::EmbeddingHelper() : ort_env(ORT_LOGGING_LEVEL_WARNING, "Resonna
 }
 
 EmbeddingHelper::~EmbeddingHelper() {
+    // 백그라운드 모델 로드가 진행 중이면 세션 생성이 끝날 때까지 대기
+    if (ort_session_future.valid()) {
+        ort_session_future.wait();
+    }
     shutdownEssentia();
 }
 
+// essentia::init()/shutdown() 은 프로세스 전역 상태(AlgorithmFactory)를 다루므로
+// 여러 EmbeddingHelper(엔진 + 단발성 호출)가 공존해도 마지막 인스턴스가 해제될 때만 shutdown 한다.
+static std::mutex g_essentiaMutex;
+static int g_essentiaRefCount = 0;
+
 void EmbeddingHelper::initEssentia() {
     if (!essentiaInitialized) {
-        essentia::init();
+        std::lock_guard<std::mutex> lock(g_essentiaMutex);
+        if (g_essentiaRefCount++ == 0) {
+            essentia::init();
+        }
         essentiaInitialized = true;
     }
 }
 
 void EmbeddingHelper::shutdownEssentia() {
     if (essentiaInitialized) {
-        essentia::shutdown();
+        std::lock_guard<std::mutex> lock(g_essentiaMutex);
+        if (--g_essentiaRefCount == 0) {
+            essentia::shutdown();
+        }
         essentiaInitialized = false;
     }
 }
 
-bool EmbeddingHelper::initOrtSession(const std::string &model_path) {
+namespace {
+    // 모델 / 외부 가중치 파일의 (크기, 수정 시각 ns). 외부 가중치가 없으면 data_size = -1
+    struct ModelStamp {
+        int64_t model_size = 0;
+        int64_t model_mtime = 0;
+        int64_t data_size = -1;
+        int64_t data_mtime = 0;
+
+        bool operator==(const ModelStamp& other) const {
+            return model_size == other.model_size && model_mtime == other.model_mtime
+                   && data_size == other.data_size && data_mtime == other.data_mtime;
+        }
+    };
+
+    constexpr char MODEL_DIGEST_MAGIC[8] = {'R', 'S', 'N', 'D', 'G', 'S', 'T', '2'};
+    constexpr const char* MODEL_DIGEST_EXTENSION = ".digest";
+
+    int64_t mtimeNs(const struct stat& st) {
+        return static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+    }
+
+    // <model_path>.digest : magic[8], ModelStamp, uint64 hash. 스탬프가 다르면(모델 교체) 무효
+    bool readModelDigest(const std::string& digest_path, const ModelStamp& stamp, uint64_t& hash) {
+        FILE* file = std::fopen(digest_path.c_str(), "rb");
+        if (file == nullptr) return false;
+        char magic[sizeof(MODEL_DIGEST_MAGIC)] = {};
+        ModelStamp stored;
+        uint64_t stored_hash = 0;
+        const bool ok = std::fread(magic, sizeof(magic), 1, file) == 1
+                        && std::fread(&stored, sizeof(stored), 1, file) == 1
+                        && std::fread(&stored_hash, sizeof(stored_hash), 1, file) == 1;
+        std::fclose(file);
+        if (!ok || std::memcmp(magic, MODEL_DIGEST_MAGIC, sizeof(magic)) != 0 || !(stored == stamp)) {
+            return false;
+        }
+        hash = stored_hash;
+        return true;
+    }
+
+    // 임시 파일에 쓴 뒤 rename (실패해도 다음 로드에서 다시 계산할 뿐이므로 경고만)
+    void writeModelDigest(const std::string& digest_path, const ModelStamp& stamp, uint64_t hash) {
+        const std::string tmp_path = digest_path + ".tmp" + std::to_string(::gettid());
+        FILE* file = std::fopen(tmp_path.c_str(), "wb");
+        bool ok = file != nullptr;
+        if (ok) {
+            ok = std::fwrite(MODEL_DIGEST_MAGIC, sizeof(MODEL_DIGEST_MAGIC), 1, file) == 1
+                 && std::fwrite(&stamp, sizeof(stamp), 1, file) == 1
+                 && std::fwrite(&hash, sizeof(hash), 1, file) == 1;
+            ok = std::fclose(file) == 0 && ok;
+        }
+        if (!ok || std::rename(tmp_path.c_str(), digest_path.c_str()) != 0) {
+            LOGW("Failed to store model digest : %s", digest_path.c_str());
+            std::remove(tmp_path.c_str());
+        }
+    }
+}
+
+// 모델 식별 해시: model.onnx 전체 + model.onnx.data 전체 (+ 각 크기)
+// 이 해시가 최적화 모델 캐시와 임베딩 저장소의 키이므로 가중치 일부만 바뀐 재학습 모델도 반드시 구분되어야 함
+// 모델 파일을 매 로드마다 읽지 않도록 (크기, 수정 시각) 스탬프와 함께 <model_path>.digest 에 영속하고
+// 프로세스 내에서는 메모리에 보관
+bool EmbeddingHelper::modelHash(const std::string &model_path, uint64_t &hash) {
+    struct stat st{};
+    if (stat(model_path.c_str(), &st) != 0) {
+        return false;
+    }
+    ModelStamp stamp;
+    stamp.model_size = st.st_size;
+    stamp.model_mtime = mtimeNs(st);
+    struct stat data_st{};
+    const std::string data_path = model_path + ".data";
+    const bool has_data = stat(data_path.c_str(), &data_st) == 0;
+    if (has_data) {
+        stamp.data_size = data_st.st_size;
+        stamp.data_mtime = mtimeNs(data_st);
+    }
+
+    static std::mutex memo_mutex;
+    static std::map<std::string, std::pair<ModelStamp, uint64_t>> memo;
+    std::lock_guard<std::mutex> lock(memo_mutex);
+    auto it = memo.find(model_path);
+    if (it != memo.end() && it->second.first == stamp) {
+        hash = it->second.second;
+        return true;
+    }
+
+    const std::string digest_path = model_path + MODEL_DIGEST_EXTENSION;
+    if (!readModelDigest(digest_path, stamp, hash)) {
+        RunTimerLogger timer("hash model");
+        Fnv1aHasher hasher;
+        hasher.update(&stamp.model_size, sizeof(stamp.model_size));
+        hasher.update(&stamp.data_size, sizeof(stamp.data_size));
+        if (!hasher.updateFile(model_path)) {
+            return false;
+        }
+        // 외부 가중치를 읽을 수 없으면 실패 (일부만 해시하면 오래된 캐시 / 임베딩이 조용히 재사용됨)
+        if (has_data && !hasher.updateFile(data_path)) {
+            LOGE("Failed to read external model data : %s", data_path.c_str());
+            return false;
+        }
+        hash = hasher.value();
+        writeModelDigest(digest_path, stamp, hash);
+    }
+    memo[model_path] = {stamp, hash};
+    return true;
+}
+
+// 최적화 모델 캐시 경로: <model_path>.opt-<모델 해시 + ORT 버전 해시>.ort
+// 모델(model.onnx + model.onnx.data) 이나 ORT 버전이 바뀌면 키가 달라져 자동으로 다시 생성됨
+std::string EmbeddingHelper::optimizedModelCachePath(const std::string &model_path) {
+    uint64_t model_hash = 0;
+    if (!modelHash(model_path, model_hash)) {
+        return {};
+    }
+
+    Fnv1aHasher hasher;
+    hasher.update(&model_hash, sizeof(model_hash));
+    hasher.update(Ort::GetVersionString());
+    hasher.update(std::to_string(ORT_API_VERSION));
+
+    return model_path + OPTIMIZED_MODEL_TAG + hasher.hex() + ".ort";
+}
+
+// 같은 모델의 이전 키 캐시 / 미완성 임시 파일 삭제
+static void removeStaleOptimizedModels(const std::string &model_path, const std::string &keep_path) {
+    const size_t slash = model_path.find_last_of('/');
+    const std::string dir = slash == std::string::npos ? "." : model_path.substr(0, slash);
+    const std::string prefix = (slash == std::string::npos ? model_path : model_path.substr(slash + 1))
+                               + EmbeddingHelper::OPTIMIZED_MODEL_TAG;
+    const std::string keep = keep_path.substr(keep_path.find_last_of('/') + 1);
+
+    DIR* dp = opendir(dir.c_str());
+    if (dp == nullptr) return;
+    while (dirent* entry = readdir(dp)) {
+        const std::string name = entry->d_name;
+        if (name.compare(0, prefix.size(), prefix) == 0 && name != keep) {
+            const std::string stale = dir + "/" + name;
+            if (std::remove(stale.c_str()) == 0) {
+                LOGI("Removed stale optimized model: %s", stale.c_str());
+            }
+        }
+    }
+    closedir(dp);
+}
+
+bool EmbeddingHelper::initOrtSession(const std::string &model_path, bool use_optimized_cache, bool map_model) {
+    using Clock = std::chrono::steady_clock;
+    auto elapsedMs = [](Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    };
+
+    const std::string cache_path = use_optimized_cache ? optimizedModelCachePath(model_path) : std::string();
+
+    // 1. 캐시 적중: 이미 최적화된 ORT 포맷 모델을 그래프 최적화 없이 로드
+    struct stat st{};
+    if (!cache_path.empty() && stat(cache_path.c_str(), &st) == 0) {
+        auto start = Clock::now();
+        if (createOrtSession(cache_path, true, std::string(), map_model)) {
+            LOGI("ONNX cold start (optimized cache) : %.3f ms (%s)", elapsedMs(start), cache_path.c_str());
+            return true;
+        }
+        LOGW("Optimized model cache is unusable, rebuilding : %s", cache_path.c_str());
+        std::remove(cache_path.c_str());
+    }
+
+    // 2. 캐시 없음: 원본 모델을 파싱 + 그래프 최적화하면서 최적화 결과를 임시 파일에 기록
+    auto start = Clock::now();
+    const std::string tmp_path = cache_path.empty() ? std::string() : cache_path + ".tmp";
+    bool loaded = createOrtSession(model_path, false, tmp_path, map_model);
+    if (!loaded && !tmp_path.empty()) {
+        // 직렬화할 수 없는 그래프(EP 컴파일 노드 등)이면 캐시 없이 다시 로드
+        std::remove(tmp_path.c_str());
+        loaded = createOrtSession(model_path, false, std::string(), map_model);
+    }
+    if (!loaded) {
+        return false;
+    }
+    LOGI("ONNX cold start (full optimization) : %.3f ms (%s)", elapsedMs(start), model_path.c_str());
+
+    // 3. 완성된 파일만 캐시 이름으로 교체 (중간에 종료되어도 깨진 캐시가 남지 않음)
+    if (!tmp_path.empty() && stat(tmp_path.c_str(), &st) == 0) {
+        if (std::rename(tmp_path.c_str(), cache_path.c_str()) == 0) {
+            LOGI("Optimized model cached : %s", cache_path.c_str());
+            removeStaleOptimizedModels(model_path, cache_path);
+        } else {
+            LOGW("Failed to store optimized model cache : %s", cache_path.c_str());
+            std::remove(tmp_path.c_str());
+        }
+    }
+    return true;
+}
+
+bool EmbeddingHelper::createOrtSession(
+        const std::string &model_path,
+        bool pre_optimized,
+        const std::string &save_optimized_path,
+        bool map_model
+) {
     Ort::SessionOptions session_options;
-    session_options.SetIntraOpNumThreads(1); // 추론 스레드 설정
+    // 추론 스레드 설정 (엔진의 스레드 예산 / 스레드 생성 훅)
+    session_options.SetIntraOpNumThreads(m_ort_threading.intra_op_threads);
+    session_options.SetInterOpNumThreads(1);
+    if (m_ort_threading.intra_op_threads > 1) {
+        // 대기 중인 intra-op 스레드가 특징 추출 작업자와 코어를 다투지 않도록 spin 대기 비활성화
+        session_options.AddConfigEntry(kOrtSessionOptionsConfigAllowIntraOpSpinning, "0");
+    }
+    if (m_ort_threading.create_thread != nullptr && m_ort_threading.join_thread != nullptr) {
+        session_options.SetCustomCreateThreadFn(m_ort_threading.create_thread);
+        session_options.SetCustomThreadCreationOptions(m_ort_threading.thread_options);
+        session_options.SetCustomJoinThreadFn(m_ort_threading.join_thread);
+    }
+
+    if (pre_optimized) {
+        // 캐시된 모델은 이미 최적화되어 있으므로 그래프 최적화를 건너뜀
+        session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_DISABLE_ALL);
+        session_options.AddConfigEntry(kOrtSessionOptionsConfigLoadModelFormat, "ORT");
+    } else if (!save_optimized_path.empty()) {
+        // 최적화된 그래프를 ORT 포맷으로 저장 (가중치 포함 - 외부 데이터 파일 불필요)
+        session_options.SetOptimizedModelFilePath(save_optimized_path.c_str());
+        session_options.AddConfigEntry(kOrtSessionOptionsConfigSaveModelFormat, "ORT");
+    }
 
     // nnapi 가속기 추가(성능 최적화)
 //    try {
@@ -50,12 +294,92 @@ bool EmbeddingHelper::initOrtSession(const std::string &model_path) {
 
     try {
         // ort_env를 사용하여 세션 객체를 생성하고 스마트 포인터에 저장합니다.
-        ort_session = std::make_unique<Ort::Session>(ort_env, model_path.c_str(), session_options);
+        if (map_model) {
+            // 모델 / 외부 가중치를 mmap 하여 메모리에서 세션 생성 (가중치가 페이지 캐시와 공유되어 힙에 중복되지 않음)
+            MappedFile model_map(model_path);
+            MappedFile data_map;
+
+            if (pre_optimized) {
+                // ORT 포맷: 매핑된 바이트를 복사 없이 모델 / 초기값(initializer)으로 직접 사용
+                session_options.AddConfigEntry(kOrtSessionOptionsConfigUseORTModelBytesDirectly, "1");
+                session_options.AddConfigEntry(kOrtSessionOptionsConfigUseORTModelBytesForInitializers, "1");
+            } else {
+                // ONNX 포맷: 버퍼에서 로드하면 모델 경로가 없으므로 외부 데이터 파일(model.onnx.data)을 메모리로 제공
+                const std::string data_path = model_path + ".data";
+                if (MappedFile::exists(data_path)) {
+                    data_map = MappedFile(data_path);
+                    const std::vector<std::string> names = {data_path.substr(data_path.find_last_of('/') + 1)};
+                    const std::vector<char*> buffers = {data_map.data()};
+                    const std::vector<size_t> lengths = {data_map.size()};
+                    session_options.AddExternalInitializersFromFilesInMemory(names, buffers, lengths);
+                }
+            }
+
+            auto session = std::make_unique<Ort::Session>(ort_env, model_map.data(), model_map.size(), session_options);
+            // 이전 세션을 먼저 해제한 뒤 매핑 교체 (세션이 매핑보다 오래 살지 않도록)
+            ort_session = std::move(session);
+            m_model_map = std::move(model_map);
+            m_external_data_map = std::move(data_map);
+        } else {
+            ort_session = std::make_unique<Ort::Session>(ort_env, model_path.c_str(), session_options);
+            m_model_map.reset();
+            m_external_data_map.reset();
+        }
+
+        // 입/출력 노드 이름은 세션 수명 동안 변하지 않으므로 여기서 1회만 조회하여 캐시
+        Ort::AllocatorWithDefaultOptions allocator;
+        m_input_names.clear();
+        m_input_names_char.clear();
+        m_output_names.clear();
+
+        size_t num_input_nodes = ort_session->GetInputCount();
+        m_input_names.reserve(num_input_nodes);
+        for (size_t i = 0; i < num_input_nodes; i++) {
+            m_input_names.emplace_back(ort_session->GetInputNameAllocated(i, allocator).get());
+        }
+        // reserve 이후 push 가 끝난 뒤 포인터를 수집해야 재할당으로 인한 dangling 이 없음
+        for (const auto& name : m_input_names) {
+            m_input_names_char.push_back(name.c_str());
+        }
+
+        size_t num_output_nodes = ort_session->GetOutputCount();
+        m_output_names.reserve(num_output_nodes);
+        for (size_t i = 0; i < num_output_nodes; i++) {
+            m_output_names.emplace_back(ort_session->GetOutputNameAllocated(i, allocator).get());
+        }
+
         LOGI("ONNX Session successfully initialized with model: %s", model_path.c_str());
         return true;
-    } catch (const Ort::Exception& e) {
+    } catch (const std::exception& e) {
+        // Ort::Exception 및 mmap 실패(std::runtime_error)
         LOGE("Failed to create ONNX Session: %s", e.what());
         ort_session.reset(); // 실패 시 세션 포인터 초기화
+        m_model_map.reset();
+        m_external_data_map.reset();
+        m_input_names.clear();
+        m_input_names_char.clear();
+        m_output_names.clear();
         return false;
     }
+}
+
+void EmbeddingHelper::initOrtSessionAsync(const std::string &model_path, bool use_optimized_cache, bool map_model) {
+    // 이전 비동기 로드가 남아있다면 먼저 정리
+    waitOrtSession();
+
+    // model_path 는 값으로 캡처 (호출 측 문자열 수명과 무관하게 동작)
+    ort_session_future = std::async(std::launch::async, [this, model_path, use_optimized_cache, map_model]() {
+        RunTimerLogger timer("initOrtSession (background)");
+        return initOrtSession(model_path, use_optimized_cache, map_model);
+    });
+}
+
+bool EmbeddingHelper::waitOrtSession() {
+    // future 는 한 번만 get 할 수 있으므로 여러 스레드(배처 / 파이프라인)가 동시에 기다려도 한 스레드만 join
+    std::lock_guard<std::mutex> lock(ort_session_wait_mutex);
+    if (ort_session_future.valid()) {
+        RunTimerLogger timer("waitOrtSession");
+        return ort_session_future.get();
+    }
+    return ort_session != nullptr;
 }
\ No newline at end of file
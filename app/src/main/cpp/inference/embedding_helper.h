@@ -12,15 +12,37 @@
 #include <string>
 #include <onnxruntime_cxx_api.h>
 #include <cstdint>
+#include <future>
+#include <mutex>
 
 #include "common/log_util.h" // 로그 유틸리티 사용
 #include "common/cal_runtime.h" // 시간 측정 유틸리티 사용
 #include "struct/embedding_config.h"
 #include "common/audio_data.h"
+#include "common/audio_source.h"
+#include "struct/spectrogram.h"
+#include "struct/feature_tensor.h"
+#include "common/mapped_file.h"
 
 namespace NdkEssentiaEmbedding {
-    // 모든 2D/1D 특징을 담을 컨테이너
-    using FullFeatures = std::map<std::string, std::vector<std::vector<float>>>;
+    // 한 세그먼트의 모든 특징 (특징마다 연속 버퍼 1개)
+    struct FullFeatures {
+        FeatureTensor mel;    // [M][T]
+        FeatureTensor chroma; // [C][T]
+        FeatureTensor tempo;  // [1][L]
+    };
+
+    class WorkerPool;
+    class InferenceBatch;
+    class PcmCache;
+
+    // ORT 세션 스레드 설정 (세션 생성 시 적용). 훅이 주어지면 ORT 는 intra-op 스레드를 훅으로 생성 / join
+    struct OrtThreading {
+        int intra_op_threads = 1;
+        OrtCustomCreateThreadFn create_thread = nullptr;
+        OrtCustomJoinThreadFn join_thread = nullptr;
+        void* thread_options = nullptr;
+    };
 
     class EmbeddingHelper {
     public:
@@ -29,48 +51,209 @@ namespace NdkEssentiaEmbedding {
 
         // 오디오 로드
         AudioData loadAudioFile(
-                const std::string& filePath,
+                const AudioSource& source,
                 const EmbeddingConfig& config = EmbeddingConfig()
         );
 
-        // 세그먼트 분할
-        std::vector<std::vector<float>> segmenter(
+        // 전체 디코딩 + segmenter (segment_only_decode 이면 세그먼트 구간만 seek 하여 디코딩하고, 불가능한 경우 전체 디코딩으로 대체)
+        // PCM 캐시가 있으면 적중 시 세그먼트 구간만 매핑에서 변환, 미적중 시 전체 디코딩하여 캐시
+        // 반환값이 PCM 버퍼를 소유하고 세그먼트는 그 안을 가리키는 뷰
+        SegmentedAudio loadAudioSegments(
+                const AudioSource& source,
+                const EmbeddingConfig& config = EmbeddingConfig()
+        );
+
+        // 세그먼트 구간만 seek 하여 디코딩 (전체 디코딩으로 대체하지 않음, segment_only_decode 와 무관)
+        // 전체 디코딩 + segmenter 와 같은 세그먼트를 보장할 수 없거나 모노 출력이 아니면 false
+        bool loadPlannedSegments(
+                const AudioSource& source,
+                const EmbeddingConfig& config,
+                SegmentedAudio& out
+        );
+
+        // 세그먼트 시작 위치(샘플) 계산 - segmenter 와 구간 디코딩이 공유
+        static std::vector<int> computeSegmentStarts(
+                int totalSamples,
+                float sampleRate,
+                const EmbeddingConfig& config = EmbeddingConfig()
+        );
+
+        // 세그먼트 분할 (audioData.samples 를 가리키는 뷰 - audioData 가 살아있는 동안만 유효)
+        std::vector<AudioView> segmenter(
                 const AudioData& audioData,
                 const EmbeddingConfig& config = EmbeddingConfig()
         );
 
-        // LogMel 추출
-        std::vector<std::vector<float>> computeLogMel(
-                const std::vector<float>& audio,
+        // STFT 파워 스펙트럼 추출 (LogMel / Tempo 공유 프론트엔드)
+        Spectrogram computeStft(
+                AudioView audio,
                 const EmbeddingConfig& config = EmbeddingConfig()
         );
 
-        // Chroma 추출
-        std::vector<std::vector<float>> computeChroma(
-                const std::vector<float>& audio,
+        // LogMel 추출 [M][T]
+        FeatureTensor computeLogMel(
+                AudioView audio,
                 const EmbeddingConfig& config = EmbeddingConfig()
         );
 
-        // tempo 추출
-        std::vector<float> computeTempo(
-                const std::vector<float>& audio,
+        // LogMel 추출 (공유 STFT 사용). out 이 비어있으면 할당, 준비된 텐서(뷰)면 그 자리에 기록
+        void computeLogMel(
+                const Spectrogram& stft,
+                const EmbeddingConfig& config,
+                FeatureTensor& out
+        );
+
+        // Chroma 추출 [C][T]
+        FeatureTensor computeChroma(
+                AudioView audio,
                 const EmbeddingConfig& config = EmbeddingConfig()
         );
 
-        // 특징 추출
-        FullFeatures extractFeatures(
-                const std::vector<float>& audio,
+        // Chroma 추출. out 이 비어있으면 할당, 준비된 텐서(뷰)면 그 열 수만큼 기록 (모자란 프레임은 0)
+        void computeChroma(
+                AudioView audio,
+                const EmbeddingConfig& config,
+                FeatureTensor& out
+        );
+
+        // tempo 추출 [1][L]
+        FeatureTensor computeTempo(
+                AudioView audio,
                 const EmbeddingConfig& config = EmbeddingConfig()
         );
 
-        // 모델 초기화
-        bool initOrtSession(const std::string& model_path);
+        // tempo 추출 (공유 STFT 사용)
+        void computeTempo(
+                const Spectrogram& stft,
+                const EmbeddingConfig& config,
+                FeatureTensor& out
+        );
+
+        // tempo 추출 (이미 계산된 LogMel [M][T] 로 onset 계산)
+        void computeTempo(
+                const FeatureTensor& logMel,
+                const EmbeddingConfig& config,
+                FeatureTensor& out
+        );
+
+        // Onset 강도 곡선 (melflux, 공유 STFT 의 크기 스펙트럼 사용) [T]
+        std::vector<float> computeOnsetEnvelope(
+                const Spectrogram& stft,
+                const EmbeddingConfig& config = EmbeddingConfig()
+        );
+
+        // Onset 강도 곡선 (LogMel dB 스펙트럼의 양의 차분 평균, librosa onset_strength 방식) [T]
+        static std::vector<float> computeOnsetEnvelope(
+                const FeatureTensor& logMel,
+                const EmbeddingConfig& config = EmbeddingConfig()
+        );
+
+        // onset 곡선 -> tempo 벡터 [1][tempo_win]
+        static void tempoFromOnset(
+                const std::vector<float>& onset,
+                const EmbeddingConfig& config,
+                FeatureTensor& out
+        );
+
+        // 시간 평균 Tempogram: 길이 winLength, hop 1 윈도우별 자기상관의 평균 중 앞 numLags 개 lag
+        static std::vector<float> meanTempogram(
+                const std::vector<float> &onset,
+                int winLength,
+                int numLags
+        );
+
+        // 시간 평균 Tempogram 을 out[numLags] 에 직접 기록
+        static void meanTempogram(
+                const std::vector<float> &onset,
+                int winLength,
+                int numLags,
+                float* out
+        );
+
+        // 특징 추출 (pool 이 주어지면 LogMel / Chroma / Tempo 를 병렬 수행)
+        FullFeatures extractFeatures(
+                AudioView audio,
+                const EmbeddingConfig& config = EmbeddingConfig(),
+                WorkerPool* pool = nullptr
+        );
+
+        // 특징 추출을 준비된 텐서(추론 배치 슬롯 등)에 직접 기록
+        void extractFeatures(
+                AudioView audio,
+                const EmbeddingConfig& config,
+                FullFeatures& out,
+                WorkerPool* pool = nullptr
+        );
+
+        // 전체 세그먼트 특징 추출 (pool 이 주어지면 세그먼트 단위 병렬 수행)
+        std::vector<FullFeatures> extractAllFeatures(
+                const std::vector<AudioView>& segments,
+                const EmbeddingConfig& config = EmbeddingConfig(),
+                WorkerPool* pool = nullptr
+        );
+
+        // 전체 세그먼트 특징을 추론 배치의 입력 버퍼에 직접 기록 (배치 shape 준비 포함)
+        void extractAllFeatures(
+                const std::vector<AudioView>& segments,
+                const EmbeddingConfig& config,
+                InferenceBatch& batch,
+                WorkerPool* pool = nullptr
+        );
+
+        // 이후 생성되는 ORT 세션의 스레드 설정 (initOrtSession 이전에 호출)
+        void setOrtThreading(const OrtThreading& threading) { m_ort_threading = threading; }
+
+        // 디코딩 PCM 캐시 설정 (nullptr 이면 사용 안 함). loadAudioFile / loadAudioSegments 가 FFmpeg 전에 조회
+        void setPcmCache(std::shared_ptr<PcmCache> cache) { m_pcm_cache = std::move(cache); }
+
+        // 최적화 모델 캐시 파일 이름 태그 (<model_path>.opt-<key>.ort)
+        static constexpr const char* OPTIMIZED_MODEL_TAG = ".opt-";
+
+        // 모델 초기화. use_optimized_cache 이면 최초 로드 시 최적화된 그래프를 모델 옆에 ORT 포맷으로 저장하고
+        // 이후 로드는 그 파일을 그래프 최적화 없이 사용. map_model 이면 모델 / 외부 가중치를 mmap 하여 메모리에서 로드
+        bool initOrtSession(const std::string& model_path, bool use_optimized_cache = true, bool map_model = false);
+
+        // 모델 초기화를 백그라운드 스레드에서 시작 (완료 대기는 waitOrtSession)
+        void initOrtSessionAsync(const std::string& model_path, bool use_optimized_cache = true, bool map_model = false);
+
+        // 모델 식별 해시 (model.onnx + model.onnx.data 전체 내용). 모델 / 외부 가중치를 읽을 수 없으면 false
+        // 결과는 (크기, 수정 시각) 과 함께 <model_path>.digest 에 저장되어 이후 로드는 파일을 다시 읽지 않음
+        static bool modelHash(const std::string& model_path, uint64_t& hash);
+
+        // 최적화 모델 캐시 경로 (모델 해시, ORT 버전으로 키 생성). 모델을 읽을 수 없으면 빈 문자열
+        static std::string optimizedModelCachePath(const std::string& model_path);
+
+        // 백그라운드 모델 초기화 완료 대기. 세션 사용 가능 여부 반환
+        bool waitOrtSession();
 
         // temp : 특징 평탄화(테스트용)
         std::map<std::string, std::vector<float>> flattenFeature(
                 const std::vector<FullFeatures> &allSegmentFeatures
         );
 
+        // temp : 기존 Essentia STFT 체인 대비 computeStft 벤치마크(테스트용)
+        // 반환: [legacyMs, fusedMs, legacyFrames, fusedFrames, maxRelDiff]
+        std::vector<float> benchmarkStft(
+                AudioView segment,
+                const EmbeddingConfig &config = EmbeddingConfig(),
+                int repeat = 5
+        );
+
+        // temp : 기존 2D 템포그램 평균 대비 meanTempogram 벤치마크(테스트용)
+        // 반환: [legacyMs, fastMs, maxRelDiff]
+        std::vector<float> benchmarkTempogram(
+                AudioView segment,
+                const EmbeddingConfig &config = EmbeddingConfig(),
+                int repeat = 5
+        );
+
+        // temp : 구간 디코딩 세그먼트와 전체 디코딩 + segmenter 세그먼트 샘플 단위 비교(테스트용)
+        // 반환: [planned(1/0), plannedSegments, fullSegments, comparedSamples, mismatchedSamples, maxAbsDiff]
+        std::vector<float> compareSegmentDecode(
+                const AudioSource& source,
+                const EmbeddingConfig &config = EmbeddingConfig()
+        );
+
         // 입력 텐서 생성
         std::vector<Ort::Value> createInputTensors(
                 const std::vector<FullFeatures> &allSegmentFeatures
@@ -82,17 +265,38 @@ namespace NdkEssentiaEmbedding {
                 const std::string &outputName
         );
 
+        // 모델 추론 (IoBinding - 배치의 입력 버퍼를 그대로 사용하고 결과는 batch.output() 에 남김)
+        void runInference(
+                InferenceBatch &batch,
+                const std::string &outputName
+        );
+
         // L2 정규화
         void l2Normalize(std::vector<float>& vec);
 
+        // L2 정규화 (제자리, 출력 텐서의 한 행 등)
+        void l2Normalize(float* vec, size_t size);
+
         // 평균 구하기
         std::vector<float> meanPooling(const std::vector<std::vector<float>> &embeddings);
 
+        // 평균 구하기 ([V][D] 텐서의 행 평균)
+        std::vector<float> meanPooling(const FeatureTensor &embeddings);
+
     private:
+        // 세션 생성 및 입/출력 이름 캐시. pre_optimized 이면 ORT 포맷 + 그래프 최적화 생략,
+        // save_optimized_path 가 주어지면 최적화된 그래프를 해당 경로에 저장, map_model 이면 mmap 버퍼에서 생성
+        bool createOrtSession(
+                const std::string& model_path,
+                bool pre_optimized,
+                const std::string& save_optimized_path,
+                bool map_model
+        );
+
         void initEssentia();
         void shutdownEssentia();
         bool essentiaInitialized = false;
-        void performHPSS(const std::vector<float>& audio, std::vector<float>& y_h, std::vector<float>& y_p);
+        void performHPSS(AudioView audio, std::vector<float>& y_h, std::vector<float>& y_p);
 
         // ONNX 텐서 데이터를 저장할 멤버 변수
         std::vector<float> m_mel_buffer;
@@ -100,7 +304,23 @@ namespace NdkEssentiaEmbedding {
         std::vector<float> m_tmp_buffer;
 
         Ort::Env ort_env;
+        OrtThreading m_ort_threading;
+        std::shared_ptr<PcmCache> m_pcm_cache;
+
+        // mmap 로드 시 세션이 참조하는 모델 / 외부 가중치 매핑 (세션보다 나중에 소멸되도록 먼저 선언)
+        MappedFile m_model_map;
+        MappedFile m_external_data_map;
+
         std::unique_ptr<Ort::Session> ort_session = nullptr;
+
+        // 세션 생성 시 1회 조회해 두는 입/출력 노드 이름 (runInference 호출마다 재조회하지 않음)
+        std::vector<std::string> m_input_names;
+        std::vector<const char*> m_input_names_char;
+        std::vector<std::string> m_output_names;
+
+        // initOrtSessionAsync 진행 상태 (세션/이름 멤버보다 먼저 소멸되도록 마지막에 선언)
+        std::future<bool> ort_session_future;
+        std::mutex ort_session_wait_mutex;
     };
 }
 #endif // NDK_ESSENTIA_TEST__HELPER_H
\ No newline at end of file
@@ -0,0 +1,253 @@
+//
+// Created by glion on 2025-12-16.
+// EmbeddingEngine 일괄 인덱싱 - 디코딩 / 특징 추출 / 추론 단계 파이프라인
+//
+
+#include "engine/embedding_engine.h"
+#include "common/bounded_queue.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+using namespace NdkEssentiaEmbedding;
+
+namespace {
+    struct DecodedSong {
+        size_t index = 0;
+        EmbeddingKey key;
+        bool keyed = false;
+        EmbeddingKey fpKey;
+        bool fingerprinted = false;
+        SegmentedAudio audio;
+        FeatureCache::Entry cached; // 특징 캐시 적중 시 (audio 는 비어있음)
+        std::unique_ptr<InferenceBatcher::Ticket> ticket; // 파이프라인 진입부터 추론 제출까지 유지
+    };
+
+    struct ExtractedSong {
+        size_t index = 0;
+        EmbeddingKey key;
+        bool keyed = false;
+        EmbeddingKey fpKey;
+        bool fingerprinted = false;
+        std::vector<FullFeatures> features;
+        FeatureCache::Entry cached; // features 가 가리키는 캐시 매핑 유지
+        std::unique_ptr<InferenceBatcher::Ticket> ticket;
+    };
+
+    struct CompletedSong {
+        size_t index = 0;
+        std::vector<float> embedding;
+        std::string error;
+    };
+
+    // 같은 일을 하는 작업자 스레드 묶음. 마지막 작업자가 끝나면 다음 단계 큐를 닫음
+    class Stage {
+    public:
+        template <typename Body, typename Downstream>
+        Stage(int workers, Body body, Downstream& downstream) : m_remaining(std::max(1, workers)) {
+            const int count = m_remaining.load();
+            for (int i = 0; i < count; ++i) {
+                m_threads.emplace_back([this, body, &downstream]() {
+                    body();
+                    if (m_remaining.fetch_sub(1) == 1) {
+                        downstream.close();
+                    }
+                });
+            }
+        }
+
+        ~Stage() { join(); }
+
+        void join() {
+            for (auto& thread : m_threads) {
+                if (thread.joinable()) thread.join();
+            }
+        }
+
+    private:
+        std::atomic<int> m_remaining;
+        std::vector<std::thread> m_threads;
+    };
+}
+
+size_t EmbeddingEngine::embedAll(
+        const std::vector<std::string>& filePaths,
+        const IndexCallback& callback,
+        const BatchIndexOptions& options
+) {
+    RunTimerLogger timer("EmbeddingEngine embedAll");
+
+    if (filePaths.empty()) {
+        return 0;
+    }
+
+    // 추론 단계는 곡 간 배처를 사용 (엔진에 배처가 없으면 이 호출 동안만 생성)
+    const int inferenceWorkers = std::max(1, options.inference_workers);
+    std::unique_ptr<InferenceBatcher> localBatcher;
+    InferenceBatcher* batcher = m_batcher.get();
+    if (batcher == nullptr) {
+        localBatcher = std::make_unique<InferenceBatcher>(
+                m_helper, m_executor, "embedding",
+                inferenceWorkers * std::max(1, m_config.segments_per_song),
+                m_options.max_batch_wait_ms);
+        batcher = localBatcher.get();
+    }
+
+    const size_t depth = static_cast<size_t>(std::max(1, options.queue_depth));
+    BoundedQueue<DecodedSong> decodedQueue(depth);
+    BoundedQueue<ExtractedSong> extractedQueue(depth);
+    BoundedQueue<CompletedSong> completedQueue(depth);
+
+    std::atomic<size_t> nextPath{0};
+
+    // 곡 단위 실패는 완료 큐로 보고하고 다음 곡 계속 처리
+    auto reportFailure = [&](size_t index, const char* what) {
+        LOGE("embedAll :: failed [%zu] %s : %s", index, filePaths[index].c_str(), what);
+        completedQueue.push(CompletedSong{index, {}, what});
+    };
+
+    // --- 1. 디코딩 단계 ---
+    Stage decodeStage(options.decode_workers, [&]() {
+        size_t index;
+        while ((index = nextPath.fetch_add(1)) < filePaths.size()) {
+            try {
+                DecodedSong song;
+                song.index = index;
+
+                // 저장소에 있으면 디코딩 없이 바로 완료
+                song.keyed = storeKey(filePaths[index], song.key);
+                CompletedSong stored;
+                stored.index = index;
+                if (song.keyed && m_store && m_store->lookup(song.key, stored.embedding)) {
+                    ++m_storeHits;
+                    if (!completedQueue.push(std::move(stored))) return;
+                    continue;
+                }
+
+                // 추론이 필요한 곡은 여기서 배처에 등록 - 디코딩 / 특징 추출 중인 곡이 있으면 배처가 먼저 제출된 곡과 묶기 위해 기다림
+                // (제출 직전에 등록하면 배처는 항상 진행 중인 곡이 없다고 보고 곡마다 바로 실행함)
+                song.ticket = std::make_unique<InferenceBatcher::Ticket>(*batcher);
+
+                // 특징 캐시에 있으면 디코딩 없이 특징 단계로 전달
+                if (loadCachedFeatures(song.keyed ? &song.key : nullptr, song.cached)) {
+                    if (!decodedQueue.push(std::move(song))) return;
+                    continue;
+                }
+
+                {
+                    // 시분할 엔진(배처 없음)이면 단계마다 예산 전체를 쓰되 한 번에 한 단계만 실행
+                    CpuExecutor::Turn turn(m_executor);
+                    song.audio = m_helper.loadAudioSegments(filePaths[index], m_config);
+                }
+                if (song.audio.empty()) {
+                    throw std::runtime_error("No audio segment extracted from : " + filePaths[index]);
+                }
+
+                // 디코딩 지문으로 저장소 조회 (같은 곡의 다른 파일이면 특징 / 추론 단계 생략)
+                song.fingerprinted = fingerprintKey(song.audio.fingerprint, song.fpKey);
+                if (song.fingerprinted && m_store->lookup(song.fpKey, stored.embedding)) {
+                    ++m_fingerprintHits;
+                    if (song.keyed) {
+                        m_store->append(song.key, stored.embedding);
+                    }
+                    if (!completedQueue.push(std::move(stored))) return;
+                    continue;
+                }
+                if (!decodedQueue.push(std::move(song))) return; // 취소됨
+            } catch (const std::exception& e) {
+                reportFailure(index, e.what());
+            }
+        }
+    }, decodedQueue);
+
+    // --- 2. 특징 추출 단계 (곡 내부 세그먼트 / 특징은 work-stealing 작업자 풀에서 병렬) ---
+    Stage featureStage(options.feature_workers, [&]() {
+        DecodedSong song;
+        while (decodedQueue.pop(song)) {
+            try {
+                ExtractedSong extracted;
+                extracted.index = song.index;
+                extracted.key = song.key;
+                extracted.keyed = song.keyed;
+                extracted.fpKey = song.fpKey;
+                extracted.fingerprinted = song.fingerprinted;
+                extracted.ticket = std::move(song.ticket);
+                if (song.cached.batchSize() > 0) {
+                    extracted.features = song.cached.segments();
+                    extracted.cached = std::move(song.cached);
+                } else {
+                    {
+                        CpuExecutor::Turn turn(m_executor);
+                        extracted.features = m_helper.extractAllFeatures(song.audio.segments, m_config, m_executor.workerPool());
+                    }
+                    song.audio = SegmentedAudio(); // PCM 은 여기서 해제
+                    storeCachedFeatures(song.keyed ? &song.key : nullptr, extracted.features);
+                }
+                if (!extractedQueue.push(std::move(extracted))) return;
+            } catch (const std::exception& e) {
+                reportFailure(song.index, e.what());
+            }
+        }
+    }, extractedQueue);
+
+    // --- 3. 추론 단계 (동시에 제출된 곡들이 배처에서 한 배치로 묶임) ---
+    Stage inferenceStage(inferenceWorkers, [&]() {
+        ExtractedSong song;
+        while (extractedQueue.pop(song)) {
+            try {
+                FeatureTensor embeddings = song.ticket->infer(song.features);
+                song.features.clear();
+                song.cached = FeatureCache::Entry();
+                song.ticket.reset();
+
+                CompletedSong completed;
+                completed.index = song.index;
+                completed.embedding = poolEmbeddings(embeddings);
+                if (song.keyed && m_store) {
+                    m_store->append(song.key, completed.embedding);
+                }
+                if (song.fingerprinted) {
+                    m_store->append(song.fpKey, completed.embedding);
+                }
+                if (!completedQueue.push(std::move(completed))) return;
+            } catch (const std::exception& e) {
+                song.ticket.reset(); // 제출 전 실패 - 배처가 이 곡을 더 기다리지 않도록 해제
+                reportFailure(song.index, e.what());
+            }
+        }
+    }, completedQueue);
+
+    // --- 4. 완료 보고 (호출 스레드) ---
+    size_t succeeded = 0;
+    std::exception_ptr callbackError;
+    CompletedSong completed;
+    while (completedQueue.pop(completed)) {
+        try {
+            callback(completed.index, filePaths[completed.index], completed.embedding, completed.error);
+        } catch (...) {
+            callbackError = std::current_exception();
+            break;
+        }
+        if (completed.error.empty()) ++succeeded;
+    }
+
+    if (callbackError) {
+        // 남은 곡은 처리하지 않고 모든 단계 중단
+        nextPath.store(filePaths.size());
+        decodedQueue.abort();
+        extractedQueue.abort();
+        completedQueue.abort();
+    }
+    decodeStage.join();
+    featureStage.join();
+    inferenceStage.join();
+
+    if (callbackError) {
+        std::rethrow_exception(callbackError);
+    }
+    LOGI("embedAll :: %zu / %zu songs indexed", succeeded, filePaths.size());
+    return succeeded;
+}
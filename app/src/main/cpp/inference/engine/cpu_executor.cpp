@@ -0,0 +1,81 @@
+//
+// Created by glion on 2025-12-14.
+// CpuExecutor 구현 - 스레드 예산 분배 및 ORT 커스텀 스레드 생성 훅
+//
+
+#include "engine/cpu_executor.h"
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <pthread.h>
+
+using namespace NdkEssentiaEmbedding;
+
+namespace {
+    // ORT 가 요청한 스레드 1개 (join 훅에서 실행기 카운트를 되돌리기 위해 소유 실행기 포인터 보관)
+    struct OrtWorkerThread {
+        std::thread thread;
+        std::atomic<int>* counter;
+    };
+}
+
+CpuExecutor::CpuExecutor(int threadBudget, int maxFeatureTasks, bool concurrentStages)
+        : m_budget(WorkerPool::resolveThreadCount(threadBudget)),
+          // 예산이 3 미만이면 단계마다 1개씩 줄 수 없으므로 스레드를 나누지 않고 차례로 공유
+          m_timeShared(!concurrentStages || m_budget < 3),
+          // 오디오 코덱은 스레드 이득이 작으므로 디코딩 몫을 가장 작게
+          m_inferenceThreads(m_timeShared ? m_budget : m_budget / 3),
+          m_decoderThreads(std::max(1, m_budget / 6)),
+          m_featureThreads(m_timeShared ? m_budget : m_budget - m_inferenceThreads - m_decoderThreads) {
+    // 호출 스레드도 작업에 참여하므로 풀 스레드는 (동시 작업 수 - 1)
+    int featureWorkers = m_featureThreads;
+    if (maxFeatureTasks > 0) {
+        featureWorkers = std::min(featureWorkers, maxFeatureTasks);
+    }
+    if (featureWorkers > 1) {
+        m_workerPool = std::make_unique<WorkerPool>(featureWorkers - 1);
+    }
+    LOGI("CpuExecutor :: thread budget %d %s (feature workers %d, ort intra-op %d, decoder %d)",
+         m_budget, m_timeShared ? "time-shared" : "concurrent", featureWorkers, m_inferenceThreads, m_decoderThreads);
+}
+
+CpuExecutor::Turn::Turn(CpuExecutor& executor) {
+    if (executor.m_timeShared) {
+        m_lock = std::unique_lock<std::mutex>(executor.m_turnMutex);
+    }
+}
+
+OrtThreading CpuExecutor::ortThreading() {
+    OrtThreading threading;
+    threading.intra_op_threads = m_inferenceThreads;
+    threading.create_thread = &CpuExecutor::createOrtThread;
+    threading.join_thread = &CpuExecutor::joinOrtThread;
+    threading.thread_options = this;
+    return threading;
+}
+
+OrtCustomThreadHandle CpuExecutor::createOrtThread(void* options, OrtThreadWorkerFn workerFn, void* param) {
+    auto* executor = static_cast<CpuExecutor*>(options);
+    const int index = executor->m_ortThreads.fetch_add(1);
+
+    auto* worker = new OrtWorkerThread{
+            std::thread([workerFn, param, index]() {
+                // 프로파일러 / systrace 에서 구분할 수 있도록 이름 지정 (최대 15자)
+                const std::string name = "ort-intra-" + std::to_string(index);
+                pthread_setname_np(pthread_self(), name.c_str());
+                workerFn(param);
+            }),
+            &executor->m_ortThreads
+    };
+    return reinterpret_cast<OrtCustomThreadHandle>(worker);
+}
+
+void CpuExecutor::joinOrtThread(OrtCustomThreadHandle handle) {
+    auto* worker = reinterpret_cast<OrtWorkerThread*>(const_cast<OrtCustomHandleType*>(handle));
+    if (worker == nullptr) return;
+    if (worker->thread.joinable()) {
+        worker->thread.join();
+    }
+    worker->counter->fetch_sub(1);
+    delete worker;
+}
@@ -0,0 +1,76 @@
+//
+// Created by glion on 2025-12-14.
+// 엔진 단위 CPU 실행기 - 하나의 스레드 예산을 특징 추출 작업자 풀 / ORT intra-op 스레드 / FFmpeg 디코더에 나누어 배분
+// ORT intra-op 스레드 수는 세션 생성 시 고정되므로 배분 방식은 생성 시 결정
+//  - 동시 단계 : 배처(동시 embed 호출)가 있고 예산이 3 이상이면 단계마다 예산을 나누어 배분 (몫의 합 = 예산)
+//  - 시분할    : 그 외(embedSingle 처럼 단계가 차례로 진행되거나 예산이 3 미만)에는 단계마다 예산 전체를 쓰되
+//                embedAll 등에서 단계가 겹치면 Turn 으로 차례를 정해 한 번에 한 단계만 CPU 사용
+//
+
+#ifndef NDK_ESSENTIA_TEST_CPU_EXECUTOR_H
+#define NDK_ESSENTIA_TEST_CPU_EXECUTOR_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include "embedding_helper.h"
+#include "common/worker_pool.h"
+
+namespace NdkEssentiaEmbedding {
+
+    class CpuExecutor {
+    public:
+        // threadBudget 이 0 이하이면 하드웨어 코어 수. maxFeatureTasks 는 특징 추출에서 동시에 의미 있는 태스크 수 상한 (0 이면 제한 없음)
+        // concurrentStages 는 단계가 동시에 진행되는 배처 사용 여부 (예산이 3 미만이면 무시하고 시분할)
+        explicit CpuExecutor(int threadBudget, int maxFeatureTasks = 0, bool concurrentStages = false);
+        ~CpuExecutor() = default;
+
+        CpuExecutor(const CpuExecutor&) = delete;
+        CpuExecutor& operator=(const CpuExecutor&) = delete;
+
+        int budget() const { return m_budget; }
+
+        // 단계별 몫 - 동시 단계는 추론(ORT intra-op) 예산의 1/3, 디코딩(FFmpeg) 1/6, 나머지는 특징 추출
+        // 시분할은 추론 / 특징 추출 모두 예산 전체, 디코딩은 예산의 1/6 (최소 1)
+        bool timeShared() const { return m_timeShared; }
+        int inferenceThreads() const { return m_inferenceThreads; }
+        int decoderThreads() const { return m_decoderThreads; }
+        int featureThreads() const { return m_featureThreads; }
+
+        // 특징 추출 작업자 풀 (호출 스레드 포함 특징 추출 몫만큼 동시 수행, 몫이 1이면 nullptr - 순차 수행)
+        WorkerPool* workerPool() const { return m_workerPool.get(); }
+
+        // ORT 세션 스레드 설정 - intra-op 스레드 수는 추론 몫, 스레드 생성은 이 실행기의 훅 사용
+        // (세션이 살아있는 동안 실행기가 유지되어야 함)
+        OrtThreading ortThreading();
+
+        // 현재 ORT 가 이 실행기를 통해 생성해 둔 스레드 수
+        int ortThreadCount() const { return m_ortThreads.load(); }
+
+        // 단계 작업(디코딩 / 특징 추출 / 추론) 1회 동안 CPU 차례 점유. 시분할일 때만 잠그고 동시 단계에서는 아무것도 하지 않음
+        // 점유 중에는 다른 단계를 기다리지 않아야 함 (큐 push / 배처 제출은 점유 밖에서)
+        class Turn {
+        public:
+            explicit Turn(CpuExecutor& executor);
+
+        private:
+            std::unique_lock<std::mutex> m_lock;
+        };
+
+    private:
+        static OrtCustomThreadHandle createOrtThread(void* options, OrtThreadWorkerFn workerFn, void* param);
+        static void joinOrtThread(OrtCustomThreadHandle handle);
+
+        int m_budget;
+        bool m_timeShared;
+        int m_inferenceThreads;
+        int m_decoderThreads;
+        int m_featureThreads;
+        std::unique_ptr<WorkerPool> m_workerPool;
+        std::atomic<int> m_ortThreads{0};
+        std::mutex m_turnMutex;
+    };
+}
+
+#endif //NDK_ESSENTIA_TEST_CPU_EXECUTOR_H
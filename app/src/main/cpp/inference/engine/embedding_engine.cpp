@@ -0,0 +1,332 @@
+//
+// Created by glion on 2025-12-01.
+// EmbeddingEngine 구현 - 전체 임베딩 파이프라인
+//
+
+#include "engine/embedding_engine.h"
+#include "common/hash_util.h"
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+
+using namespace NdkEssentiaEmbedding;
+
+EmbeddingEngine::EmbeddingEngine(
+        const std::string& modelPath,
+        const EmbeddingConfig& config,
+        const EngineOptions& options
+) : m_config(config),
+    m_options(options),
+    m_modelPath(modelPath),
+    // 세그먼트당 LogMel / Chroma / Tempo 3개 태스크. 배처가 있으면 여러 곡의 단계가 동시에 진행됨
+    m_executor(options.thread_budget, std::max(0, config.segments_per_song) * 3, options.max_batch_segments > 0) {
+    RunTimerLogger timer("EmbeddingEngine init");
+
+    // 디코딩 / 추론은 각 단계 몫만 사용 (동시 단계는 몫의 합이 예산 이내, 시분할은 한 번에 한 단계만 실행)
+    m_config.decoder_threads = m_executor.decoderThreads();
+    m_helper.setOrtThreading(m_executor.ortThreading());
+
+    if (m_options.async_model_load) {
+        // 모델 로드(model.onnx + model.onnx.data)를 첫 embed 의 디코딩/특징 추출과 겹치도록 백그라운드에서 시작
+        m_helper.initOrtSessionAsync(modelPath, m_options.optimized_model_cache, m_options.mmap_model);
+    } else if (!m_helper.initOrtSession(modelPath, m_options.optimized_model_cache, m_options.mmap_model)) {
+        throw std::runtime_error("Failed to load ONNX model: " + modelPath);
+    }
+
+    // 저장소 / 특징 캐시 키의 설정 해시 (특징 결과와 무관한 decoder_threads 는 제외됨)
+    m_configHash = hashEmbeddingConfig(m_config);
+
+    if (m_options.embedding_store || m_options.feature_cache || m_options.pcm_cache) {
+        // 캐시 키는 파일 전체 내용 해시 - 같은 파일(스탬프)은 다시 읽지 않도록 모델 디렉터리에 영속
+        try {
+            m_contentDigest = ContentDigest::shared(ContentDigest::defaultPath(modelPath));
+        } catch (const std::exception& e) {
+            LOGW("Content digest disabled (hash on every lookup) : %s", e.what());
+        }
+    }
+
+    if (m_options.embedding_store) {
+        // 모델 / 설정 해시가 키에 포함되므로 모델이나 설정이 바뀌면 이전 레코드는 적중하지 않음
+        // (다른 모델의 레코드는 저장소를 열 때 압축으로 제거)
+        const std::string storePath = m_options.embedding_store_path.empty()
+                                      ? EmbeddingStore::defaultPath(modelPath) : m_options.embedding_store_path;
+        try {
+            if (EmbeddingHelper::modelHash(modelPath, m_modelHash)) {
+                m_store = EmbeddingStore::shared(storePath, m_modelHash);
+            }
+        } catch (const std::exception& e) {
+            LOGW("Embedding store disabled : %s", e.what());
+        }
+    }
+
+    if (m_options.feature_cache) {
+        // 특징 캐시 키는 (오디오 내용, 설정) 뿐이므로 모델이 바뀌어도 재사용
+        const std::string cacheDir = m_options.feature_cache_dir.empty()
+                                     ? FeatureCache::defaultDir(modelPath) : m_options.feature_cache_dir;
+        try {
+            m_featureCache = std::make_unique<FeatureCache>(
+                    cacheDir, m_options.feature_cache_fp16 ? FeatureCache::Precision::Float16
+                                                           : FeatureCache::Precision::Float32);
+        } catch (const std::exception& e) {
+            LOGW("Feature cache disabled : %s", e.what());
+        }
+    }
+
+    if (m_options.pcm_cache) {
+        const std::string cacheDir = m_options.pcm_cache_dir.empty()
+                                     ? PcmCache::defaultDir(modelPath) : m_options.pcm_cache_dir;
+        try {
+            m_helper.setPcmCache(PcmCache::shared(
+                    cacheDir,
+                    static_cast<uint64_t>(std::max(0, m_options.pcm_cache_budget_mb)) * 1024 * 1024,
+                    m_options.pcm_cache_fp16 ? PcmCache::Format::Float16 : PcmCache::Format::Int16,
+                    m_contentDigest));
+        } catch (const std::exception& e) {
+            LOGW("PCM cache disabled : %s", e.what());
+        }
+    }
+
+    if (m_options.max_batch_segments > 0) {
+        m_batcher = std::make_unique<InferenceBatcher>(
+                m_helper, m_executor, "embedding", m_options.max_batch_segments, m_options.max_batch_wait_ms);
+    }
+}
+
+std::vector<float> EmbeddingEngine::embed(const AudioSource& source) {
+    // 0. 저장소 조회 - 적중하면 디코딩 / 특징 / 추론 없이 반환
+    EmbeddingKey key;
+    const bool keyed = storeKey(source, key);
+    std::vector<float> embedding;
+    if (keyed && m_store && m_store->lookup(key, embedding)) {
+        LOGD("Embedding store hit : %s", source.describe().c_str());
+        ++m_storeHits;
+        return embedding;
+    }
+
+    const EmbeddingKey* cacheKey = keyed ? &key : nullptr;
+    embedding = m_batcher ? embedBatched(source, cacheKey) : embedSingle(source, cacheKey);
+
+    if (keyed && m_store) {
+        m_store->append(key, embedding);
+    }
+    return embedding;
+}
+
+bool EmbeddingEngine::storeKey(const AudioSource& source, EmbeddingKey& key) const {
+    if (!m_store && !m_featureCache) {
+        return false;
+    }
+    key.config = m_configHash;
+    key.model = m_modelHash;
+    return m_contentDigest ? m_contentDigest->hash(source, key.content) : hashAudioContent(source, key.content);
+}
+
+bool EmbeddingEngine::fingerprintKey(const AudioFingerprint& fingerprint, EmbeddingKey& key) const {
+    if (!m_store || !fingerprint.valid()) {
+        return false;
+    }
+    // 파일 내용 해시와 같은 값이 되지 않도록 구분 태그와 함께 해시
+    Fnv1aHasher hasher;
+    hasher.update("packets");
+    hasher.update(&fingerprint.packets, sizeof(fingerprint.packets));
+    key.content = hasher.value();
+    key.config = m_configHash;
+    key.model = m_modelHash;
+    return true;
+}
+
+bool EmbeddingEngine::findStored(
+        const std::string& modelPath,
+        const AudioSource& source,
+        std::vector<float>& out,
+        const EmbeddingConfig& config
+) {
+    static std::mutex mutex;
+    static std::map<std::string, std::pair<std::shared_ptr<EmbeddingStore>, std::shared_ptr<ContentDigest>>> opened;
+
+    EmbeddingKey key;
+    key.config = hashEmbeddingConfig(config);
+    if (!EmbeddingHelper::modelHash(modelPath, key.model)) {
+        return false;
+    }
+    try {
+        std::shared_ptr<EmbeddingStore> store;
+        std::shared_ptr<ContentDigest> digest;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto& entry = opened[modelPath];
+            if (!entry.first) {
+                entry.first = EmbeddingStore::shared(EmbeddingStore::defaultPath(modelPath), key.model);
+                entry.second = ContentDigest::shared(ContentDigest::defaultPath(modelPath));
+            }
+            store = entry.first;
+            digest = entry.second;
+        }
+        if (!digest->hash(source, key.content) || !store->lookup(key, out)) {
+            return false;
+        }
+        LOGD("Embedding store hit : %s", source.describe().c_str());
+        return true;
+    } catch (const std::exception& e) {
+        LOGW("Embedding store unavailable : %s", e.what());
+        return false;
+    }
+}
+
+EmbeddingEngine::CacheStats EmbeddingEngine::cacheStats() const {
+    CacheStats stats;
+    stats.store_hits = m_storeHits.load();
+    stats.fingerprint_hits = m_fingerprintHits.load();
+    stats.feature_cache_hits = m_featureCacheHits.load();
+    stats.store_records = m_store ? m_store->size() : 0;
+    return stats;
+}
+
+bool EmbeddingEngine::loadCachedFeatures(const EmbeddingKey* key, FeatureCache::Entry& entry) const {
+    if (key == nullptr || !m_featureCache || !m_featureCache->load(key->content, key->config, entry)) {
+        return false;
+    }
+    ++m_featureCacheHits;
+    return true;
+}
+
+void EmbeddingEngine::storeCachedFeatures(const EmbeddingKey* key, const std::vector<FullFeatures>& features) const {
+    if (key != nullptr && m_featureCache) {
+        m_featureCache->store(key->content, key->config, features);
+    }
+}
+
+std::vector<float> EmbeddingEngine::embedSingle(const AudioSource& source, const EmbeddingKey* key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    RunTimerLogger timer("EmbeddingEngine embed");
+
+    EmbeddingKey fpKey;
+    bool fingerprinted = false;
+    FeatureCache::Entry cached;
+    if (loadCachedFeatures(key, cached)) {
+        // 1~3. 특징 캐시 적중 - 디코딩 / 특징 추출 없이 저장된 입력 텐서 사용 (float32 는 매핑을 그대로 바인딩)
+        LOGD("Feature cache hit : %s", source.describe().c_str());
+        cached.bindTo(m_batch);
+    } else {
+        // 1~2. 오디오 로드 및 세그먼트 분할 (가능하면 세그먼트 구간만 디코딩, 세그먼트는 디코딩 버퍼의 뷰)
+        // 단계마다 CPU 차례 점유 - 같은 엔진의 embedAll 이 진행 중이어도 예산을 넘지 않음
+        SegmentedAudio audio;
+        {
+            CpuExecutor::Turn turn(m_executor);
+            audio = m_helper.loadAudioSegments(source, m_config);
+        }
+        if (audio.empty()) {
+            throw std::runtime_error("No audio segment extracted from : " + source.describe());
+        }
+
+        // 디코딩 중 계산한 지문으로 저장소 조회 - 같은 곡의 다른 파일이면 특징 추출 / 추론 생략
+        fingerprinted = fingerprintKey(audio.fingerprint, fpKey);
+        std::vector<float> stored;
+        if (fingerprinted && m_store->lookup(fpKey, stored)) {
+            LOGD("Embedding store hit (fingerprint) : %s", source.describe().c_str());
+            ++m_fingerprintHits;
+            return stored;
+        }
+
+        // 3. 세그먼트 별 특징 추출 (Mel, Chroma, Tempo) - 작업자 풀에서 세그먼트 병렬 수행
+        // 각 세그먼트는 세션에 바인딩될 입력 버퍼의 자기 슬롯에 직접 기록 (중간 버퍼 / 패킹 복사 없음)
+        {
+            CpuExecutor::Turn turn(m_executor);
+            m_helper.extractAllFeatures(audio.segments, m_config, m_batch, m_executor.workerPool());
+        }
+
+        if (key != nullptr && m_featureCache) {
+            std::vector<FullFeatures> slots;
+            for (size_t v = 0; v < m_batch.batchSize(); ++v) {
+                slots.push_back(m_batch.slot(v));
+            }
+            storeCachedFeatures(key, slots);
+        }
+    }
+
+    // 4. ONNX 모델 추론 (IoBinding)
+    // 백그라운드 모델 로드는 추론 직전에만 join
+    if (!m_helper.waitOrtSession()) {
+        throw std::runtime_error("Failed to load ONNX model: " + m_modelPath);
+    }
+    {
+        CpuExecutor::Turn turn(m_executor);
+        m_helper.runInference(m_batch, "embedding");
+    }
+
+    // 5. ONNX 임베딩 후처리 (출력 버퍼 [V][D] 에서 제자리 수행)
+    std::vector<float> embedding = poolEmbeddings(m_batch.output());
+    if (fingerprinted) {
+        m_store->append(fpKey, embedding);
+    }
+    return embedding;
+}
+
+std::vector<float> EmbeddingEngine::embedBatched(const AudioSource& source, const EmbeddingKey* key) {
+    RunTimerLogger timer("EmbeddingEngine embed (batched)");
+
+    // 제출 전까지 배처가 이 곡을 기다릴 수 있도록 먼저 등록
+    InferenceBatcher::Ticket ticket(*m_batcher);
+
+    EmbeddingKey fpKey;
+    bool fingerprinted = false;
+    std::vector<FullFeatures> allSegmentFeatures;
+    FeatureCache::Entry cached;
+    if (loadCachedFeatures(key, cached)) {
+        // 1~3. 특징 캐시 적중 - 저장된 세그먼트 특징 (매핑의 뷰) 사용
+        LOGD("Feature cache hit : %s", source.describe().c_str());
+        allSegmentFeatures = cached.segments();
+    } else {
+        // 1~2. 오디오 로드 및 세그먼트 분할
+        SegmentedAudio audio;
+        {
+            CpuExecutor::Turn turn(m_executor);
+            audio = m_helper.loadAudioSegments(source, m_config);
+        }
+        if (audio.empty()) {
+            throw std::runtime_error("No audio segment extracted from : " + source.describe());
+        }
+
+        // 디코딩 지문으로 저장소 조회
+        fingerprinted = fingerprintKey(audio.fingerprint, fpKey);
+        std::vector<float> stored;
+        if (fingerprinted && m_store->lookup(fpKey, stored)) {
+            LOGD("Embedding store hit (fingerprint) : %s", source.describe().c_str());
+            ++m_fingerprintHits;
+            return stored;
+        }
+
+        // 3. 세그먼트 별 특징 추출 (다른 곡과 작업자 풀 공유)
+        {
+            CpuExecutor::Turn turn(m_executor);
+            allSegmentFeatures = m_helper.extractAllFeatures(audio.segments, m_config, m_executor.workerPool());
+        }
+        storeCachedFeatures(key, allSegmentFeatures);
+    }
+
+    // 4. 다른 곡의 세그먼트와 함께 배치 추론 - 이 곡의 행 [V][D] 만 돌려받음
+    FeatureTensor embeddings = ticket.infer(allSegmentFeatures);
+
+    // 5. ONNX 임베딩 후처리
+    std::vector<float> embedding = poolEmbeddings(embeddings);
+    if (fingerprinted) {
+        m_store->append(fpKey, embedding);
+    }
+    return embedding;
+}
+
+std::vector<float> EmbeddingEngine::poolEmbeddings(FeatureTensor& embeddings) {
+    // 1. 세그먼트별 정규화
+    for (size_t v = 0; v < embeddings.rows(); ++v) { // [V] 만큼 반복
+        m_helper.l2Normalize(embeddings.row(v), embeddings.cols());
+    }
+    // 2. 평균 풀링
+    std::vector<float> finalEmbedding = m_helper.meanPooling(embeddings);
+    if (finalEmbedding.empty()) {
+        throw std::runtime_error("Mean pooling resulted in an empty vector.");
+    }
+    // 3. 최종 정규화
+    m_helper.l2Normalize(finalEmbedding);
+
+    return finalEmbedding;
+}
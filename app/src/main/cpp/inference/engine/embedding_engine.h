@@ -0,0 +1,150 @@
+//
+// Created by glion on 2025-12-01.
+// EmbeddingEngine 클래스 선언 헤더파일
+// JNI 호출마다 EmbeddingHelper 를 새로 만들지 않도록, Essentia 초기화 상태와 ORT 세션을 유지하는 장수(long-lived) 엔진
+//
+
+#ifndef NDK_ESSENTIA_TEST_EMBEDDING_ENGINE_H
+#define NDK_ESSENTIA_TEST_EMBEDDING_ENGINE_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "embedding_helper.h"
+#include "struct/engine_options.h"
+#include "engine/cpu_executor.h"
+#include "engine/inference_batcher.h"
+#include "cache/content_digest.h"
+#include "cache/embedding_store.h"
+#include "cache/feature_cache.h"
+#include "cache/pcm_cache.h"
+#include "onnx/inference_batch.h"
+
+namespace NdkEssentiaEmbedding {
+
+    class EmbeddingEngine {
+    public:
+        // 모델을 1회 로드하고 Essentia 를 초기화된 상태로 유지. 모델 로드 실패 시 std::runtime_error
+        // (async_model_load 인 경우 로드 실패는 첫 embed 호출에서 예외로 전달됨)
+        explicit EmbeddingEngine(
+                const std::string& modelPath,
+                const EmbeddingConfig& config = EmbeddingConfig(),
+                const EngineOptions& options = EngineOptions()
+        );
+        ~EmbeddingEngine() = default;
+
+        EmbeddingEngine(const EmbeddingEngine&) = delete;
+        EmbeddingEngine& operator=(const EmbeddingEngine&) = delete;
+
+        // 오디오 1곡에 대한 최종 임베딩 (로드 -> 세그먼트 -> 특징 -> 추론 -> 후처리)
+        // source 는 파일 경로 / fd 구간 / 메모리 버퍼 (fd / 메모리는 복사 없이 그 자리에서 디코딩)
+        // 곡 간 배칭(max_batch_segments > 0) 사용 시 여러 스레드에서 동시에 호출하면 추론이 한 배치로 묶임
+        std::vector<float> embed(const AudioSource& source);
+
+        // 엔진 생성(모델 로드) 없이 기본 저장소(<모델 경로>.store)에서 임베딩 조회. 적중 시 out 에 복사하고 true
+        // 반복 조회가 저장소를 다시 인덱싱하지 않도록 모델 경로별 저장소 / 내용 해시 캐시는 프로세스에 유지
+        static bool findStored(
+                const std::string& modelPath,
+                const AudioSource& source,
+                std::vector<float>& out,
+                const EmbeddingConfig& config = EmbeddingConfig()
+        );
+
+        // 저장소 / 특징 캐시 적중 횟수 (엔진 생성 이후 누적) 와 저장소 레코드 수
+        struct CacheStats {
+            uint64_t store_hits = 0;         // 파일 내용 키 적중 (디코딩 없이 반환)
+            uint64_t fingerprint_hits = 0;   // 디코딩 지문 키 적중 (특징 추출 / 추론 없이 반환)
+            uint64_t feature_cache_hits = 0; // 특징 캐시 적중 (디코딩 / 특징 추출 없이 추론)
+            uint64_t store_records = 0;
+        };
+        CacheStats cacheStats() const;
+
+        // 곡 1개 인덱싱 완료 콜백 (index 는 paths 내 위치, 실패 시 embedding 은 비어있고 error 에 사유)
+        using IndexCallback = std::function<void(size_t index,
+                                                 const std::string& path,
+                                                 const std::vector<float>& embedding,
+                                                 const std::string& error)>;
+
+        // 여러 곡 일괄 인덱싱. 디코딩 / 특징 추출 / 추론을 고정 깊이 큐로 연결한 파이프라인 단계로 겹쳐 수행하고
+        // 완료된 곡부터 (완료 순서대로) 호출 스레드에서 callback 호출. callback 이 예외를 던지면 파이프라인을 중단하고 다시 던짐
+        // 반환: 성공한 곡 수
+        size_t embedAll(
+                const std::vector<std::string>& filePaths,
+                const IndexCallback& callback,
+                const BatchIndexOptions& options = BatchIndexOptions()
+        );
+
+        // temp : 스레드 예산 1 ~ maxBudget(0 이면 코어 수) 별 embed 평균 소요시간(ms) 벤치마크(테스트용)
+        // 예산마다 엔진(배처 없음 - ORT / 특징 추출이 예산 전체 사용)을 새로 만들고 1회 워밍업 후 repeat 회 측정
+        // 반환: [budget=1 ms, budget=2 ms, ...]
+        static std::vector<float> benchmarkThreadBudget(
+                const std::string& modelPath,
+                const std::string& filePath,
+                int maxBudget = 0,
+                int repeat = 3
+        );
+
+    private:
+        // 곡마다 m_batch 로 추론하는 경로 (한 번에 하나만 수행). key 가 있으면 특징 캐시 사용
+        std::vector<float> embedSingle(const AudioSource& source, const EmbeddingKey* key);
+
+        // 저장소 / 특징 캐시 키 생성 (둘 다 사용하지 않거나 파일을 읽을 수 없으면 false)
+        bool storeKey(const AudioSource& source, EmbeddingKey& key) const;
+
+        // 디코딩 지문(압축 패킷 해시) 기반 저장소 키 - 복사 / 이름 변경 / 태그 수정된 같은 곡을 디코딩 직후 적중
+        // (저장소를 사용하지 않거나 지문이 없으면 false)
+        bool fingerprintKey(const AudioFingerprint& fingerprint, EmbeddingKey& key) const;
+
+        // 곡 간 배칭 경로 - 디코딩 / 특징 추출은 호출 스레드에서 동시 수행, 추론만 배처에서 묶어서 실행
+        std::vector<float> embedBatched(const AudioSource& source, const EmbeddingKey* key);
+
+        // 특징 캐시 조회 (캐시를 사용하지 않거나 없으면 false)
+        bool loadCachedFeatures(const EmbeddingKey* key, FeatureCache::Entry& entry) const;
+
+        // 특징 캐시 저장 (캐시를 사용하지 않으면 무시)
+        void storeCachedFeatures(const EmbeddingKey* key, const std::vector<FullFeatures>& features) const;
+
+        // 세그먼트 임베딩 [V][D] -> 세그먼트별 L2 정규화 -> 평균 풀링 -> 최종 L2 정규화
+        std::vector<float> poolEmbeddings(FeatureTensor& embeddings);
+
+        EmbeddingConfig m_config;
+        EngineOptions m_options;
+        std::string m_modelPath;
+
+        // 스레드 예산을 공유하는 실행기 (ORT 스레드 생성 훅을 제공하므로 세션을 가진 m_helper 보다 먼저 선언)
+        CpuExecutor m_executor;
+
+        EmbeddingHelper m_helper;
+
+        // 세션에 바인딩된 입력 / 출력 버퍼 (shape 이 같으면 곡마다 재사용, 세션보다 먼저 소멸되도록 m_helper 뒤에 선언)
+        InferenceBatch m_batch;
+
+        // 곡 간 동적 배처 (max_batch_segments 가 0 이면 nullptr - 곡마다 m_batch 로 추론)
+        std::unique_ptr<InferenceBatcher> m_batcher;
+
+        // 오디오 내용 해시 영속 캐시 (저장소 / 특징 캐시 / PCM 캐시 중 하나라도 사용할 때만, 열 수 없으면 nullptr)
+        std::shared_ptr<ContentDigest> m_contentDigest;
+
+        // 임베딩 저장소 (사용하지 않으면 nullptr) 와 현재 설정 / 모델 해시
+        std::shared_ptr<EmbeddingStore> m_store;
+        uint64_t m_configHash = 0;
+        uint64_t m_modelHash = 0;
+
+        // 세그먼트 특징 캐시 (사용하지 않으면 nullptr)
+        std::unique_ptr<FeatureCache> m_featureCache;
+
+        // 적중 횟수 (cacheStats). 조회 함수(const)에서도 집계하므로 mutable
+        mutable std::atomic<uint64_t> m_storeHits{0};
+        mutable std::atomic<uint64_t> m_fingerprintHits{0};
+        mutable std::atomic<uint64_t> m_featureCacheHits{0};
+
+        // 배치 버퍼(m_batch)를 공유하므로 embed 는 한 번에 하나만 수행
+        std::mutex m_mutex;
+    };
+}
+
+#endif //NDK_ESSENTIA_TEST_EMBEDDING_ENGINE_H
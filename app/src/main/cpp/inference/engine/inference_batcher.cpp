@@ -0,0 +1,186 @@
+//
+// Created by glion on 2025-12-15.
+// InferenceBatcher 구현
+//
+
+#include "engine/inference_batcher.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <tuple>
+
+using namespace NdkEssentiaEmbedding;
+
+namespace {
+    // 배치로 묶을 수 있는 세그먼트 shape (M, C, T, L)
+    std::tuple<size_t, size_t, size_t, size_t> shapeOf(const FullFeatures& features) {
+        return std::make_tuple(features.mel.rows(), features.chroma.rows(), features.mel.cols(), features.tempo.cols());
+    }
+}
+
+InferenceBatcher::InferenceBatcher(
+        EmbeddingHelper& helper,
+        CpuExecutor& executor,
+        std::string outputName,
+        int maxBatchSegments,
+        int maxWaitMs
+) : m_helper(helper),
+    m_executor(executor),
+    m_outputName(std::move(outputName)),
+    m_maxBatchSegments(static_cast<size_t>(std::max(1, maxBatchSegments))),
+    m_maxWait(std::max(0, maxWaitMs)),
+    m_thread(&InferenceBatcher::dispatchLoop, this) {}
+
+InferenceBatcher::~InferenceBatcher() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+InferenceBatcher::Ticket::Ticket(InferenceBatcher& batcher) : m_batcher(batcher) {
+    std::lock_guard<std::mutex> lock(m_batcher.m_mutex);
+    ++m_batcher.m_active;
+}
+
+InferenceBatcher::Ticket::~Ticket() {
+    if (m_submitted) return;
+    // 제출 없이 종료(예외 등) - 배처가 이 곡을 더 기다리지 않도록 알림
+    {
+        std::lock_guard<std::mutex> lock(m_batcher.m_mutex);
+        --m_batcher.m_active;
+    }
+    m_batcher.m_cv.notify_all();
+}
+
+FeatureTensor InferenceBatcher::Ticket::infer(std::vector<FullFeatures>& segments) {
+    if (m_submitted) {
+        throw std::logic_error("InferenceBatcher ticket already submitted.");
+    }
+    if (segments.empty()) {
+        throw std::invalid_argument("No segment features to infer.");
+    }
+
+    auto request = std::make_unique<Request>();
+    request->segments = &segments;
+    request->arrival = std::chrono::steady_clock::now();
+    std::future<FeatureTensor> result = request->result.get_future();
+    {
+        std::lock_guard<std::mutex> lock(m_batcher.m_mutex);
+        m_batcher.m_queue.push_back(std::move(request));
+        --m_batcher.m_active;
+        m_submitted = true;
+    }
+    m_batcher.m_cv.notify_all();
+
+    return result.get();
+}
+
+void InferenceBatcher::dispatchLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_cv.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+        if (m_queue.empty()) {
+            return; // m_stop
+        }
+
+        auto queuedSegments = [this]() {
+            size_t rows = 0;
+            for (const auto& request : m_queue) rows += request->segments->size();
+            return rows;
+        };
+
+        // 배치가 차거나, 특징 추출 중인 곡이 없거나, 가장 오래된 요청이 최대 대기 시간에 도달할 때까지 대기
+        const auto deadline = m_queue.front()->arrival + m_maxWait;
+        m_cv.wait_until(lock, deadline, [&]() {
+            return m_stop || m_active == 0 || queuedSegments() >= m_maxBatchSegments;
+        });
+
+        // 가장 오래된 요청과 shape 이 같은 요청을 도착 순서대로 최대 배치 크기까지 수집 (첫 요청은 크기와 무관하게 포함)
+        std::vector<std::unique_ptr<Request>> taken;
+        const auto shape = shapeOf(m_queue.front()->segments->front());
+        size_t rows = 0;
+        for (auto it = m_queue.begin(); it != m_queue.end();) {
+            const size_t requestRows = (*it)->segments->size();
+            if (!taken.empty() && rows + requestRows > m_maxBatchSegments) break;
+            if (shapeOf((*it)->segments->front()) != shape) {
+                ++it;
+                continue;
+            }
+            rows += requestRows;
+            taken.push_back(std::move(*it));
+            it = m_queue.erase(it);
+        }
+
+        lock.unlock();
+        execute(taken);
+        lock.lock();
+    }
+}
+
+void InferenceBatcher::execute(std::vector<std::unique_ptr<Request>>& requests) {
+    RunTimerLogger timer("InferenceBatcher execute");
+
+    try {
+        // 백그라운드 모델 로드는 첫 배치 직전에 디스패치 스레드에서만 join
+        if (!m_sessionReady) {
+            if (!m_helper.waitOrtSession()) {
+                throw std::runtime_error("Failed to load ONNX model.");
+            }
+            m_sessionReady = true;
+        }
+
+        const FullFeatures& first = requests.front()->segments->front();
+        const size_t M = first.mel.rows();
+        const size_t C = first.chroma.rows();
+        const size_t T = first.mel.cols();
+        const size_t L = first.tempo.cols();
+
+        size_t V = 0;
+        for (const auto& request : requests) V += request->segments->size();
+        m_batch.prepare(V, M, C, T, L);
+
+        // 곡 순서대로 세그먼트를 배치 슬롯에 복사
+        size_t v = 0;
+        for (const auto& request : requests) {
+            for (const FullFeatures& segment : *request->segments) {
+                FullFeatures slot = m_batch.slot(v++);
+                segment.mel.copyTo(slot.mel.data(), M, T);
+                segment.chroma.copyTo(slot.chroma.data(), C, T);
+                segment.tempo.copyTo(slot.tempo.data(), 1, L);
+            }
+        }
+
+        {
+            CpuExecutor::Turn turn(m_executor);
+            m_helper.runInference(m_batch, m_outputName);
+        }
+        const FeatureTensor& output = m_batch.output();
+        LOGI("InferenceBatcher :: %zu songs, %zu segments in one batch", requests.size(), V);
+
+        // 곡별 출력 행 [V_song][D] 분배
+        const size_t D = output.cols();
+        size_t row = 0;
+        for (auto& request : requests) {
+            const size_t songRows = request->segments->size();
+            FeatureTensor rows(songRows, D);
+            for (size_t r = 0; r < songRows; ++r) {
+                std::memcpy(rows.row(r), output.row(row + r), D * sizeof(float));
+            }
+            row += songRows;
+            request->result.set_value(std::move(rows));
+        }
+    } catch (...) {
+        for (auto& request : requests) {
+            try {
+                request->result.set_exception(std::current_exception());
+            } catch (const std::future_error&) {
+                // 이미 결과가 전달된 요청
+            }
+        }
+    }
+}
@@ -0,0 +1,85 @@
+//
+// Created by glion on 2025-12-15.
+// 곡 간 동적 배칭 - 여러 곡의 세그먼트 특징을 모아 한 번의 ONNX 추론으로 실행하고 곡마다 자신의 출력 행을 돌려줌
+// 최대 배치 크기(세그먼트 수) 또는 최대 대기 시간에 도달하면 실행. 특징 추출 중인 다른 곡이 없으면 기다리지 않고 바로 실행
+//
+
+#ifndef NDK_ESSENTIA_TEST_INFERENCE_BATCHER_H
+#define NDK_ESSENTIA_TEST_INFERENCE_BATCHER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "embedding_helper.h"
+#include "engine/cpu_executor.h"
+#include "onnx/inference_batch.h"
+
+namespace NdkEssentiaEmbedding {
+
+    class InferenceBatcher {
+    public:
+        // helper 의 세션으로 outputName 출력을 추론. maxBatchSegments 는 한 번에 실행할 최대 세그먼트 수
+        // 추론은 executor 의 CPU 차례를 점유하고 실행 (시분할이면 다른 단계와 겹치지 않음)
+        InferenceBatcher(EmbeddingHelper& helper, CpuExecutor& executor, std::string outputName,
+                         int maxBatchSegments, int maxWaitMs);
+        ~InferenceBatcher();
+
+        InferenceBatcher(const InferenceBatcher&) = delete;
+        InferenceBatcher& operator=(const InferenceBatcher&) = delete;
+
+        // 곡 1개의 진행 표시. 살아있는 동안 배처는 이 곡의 제출을 (최대 대기 시간 이내에서) 기다릴 수 있음
+        // 디코딩 전에 생성해야 진행 중인 곡으로 집계됨 (단계 사이로 넘길 때는 unique_ptr 로 소유)
+        class Ticket {
+        public:
+            explicit Ticket(InferenceBatcher& batcher);
+            ~Ticket();
+
+            Ticket(const Ticket&) = delete;
+            Ticket& operator=(const Ticket&) = delete;
+
+            // 세그먼트 특징 제출 후 이 곡의 출력 행 [V][D] 반환 (블로킹). 추론 실패 시 예외
+            FeatureTensor infer(std::vector<FullFeatures>& segments);
+
+        private:
+            InferenceBatcher& m_batcher;
+            bool m_submitted = false;
+        };
+
+    private:
+        struct Request {
+            std::vector<FullFeatures>* segments;
+            std::promise<FeatureTensor> result;
+            std::chrono::steady_clock::time_point arrival;
+        };
+
+        void dispatchLoop();
+        // 요청 묶음을 배치 버퍼에 복사하여 1회 추론하고 곡별 행을 돌려줌
+        void execute(std::vector<std::unique_ptr<Request>>& requests);
+
+        EmbeddingHelper& m_helper;
+        CpuExecutor& m_executor;
+        std::string m_outputName;
+        size_t m_maxBatchSegments;
+        std::chrono::milliseconds m_maxWait;
+
+        InferenceBatch m_batch; // 디스패치 스레드 전용
+        bool m_sessionReady = false;
+
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        std::deque<std::unique_ptr<Request>> m_queue;
+        int m_active = 0; // Ticket 을 가졌지만 아직 제출하지 않은 곡 수
+        bool m_stop = false;
+
+        std::thread m_thread; // 마지막에 선언 (다른 멤버 초기화 이후 시작)
+    };
+}
+
+#endif //NDK_ESSENTIA_TEST_INFERENCE_BATCHER_H
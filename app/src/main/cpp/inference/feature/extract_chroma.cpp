@@ -4,121 +4,164 @@
 //
 
 #include "embedding_helper.h"
-#include <pool.h>
-#include <algorithmfactory.h>
+#include "feature/stft_engine.h"
+#include <algorithm>
+#include <cmath>
 #include <vector>
 #include <string>
 #include <memory>
-#include <essentiamath.h>
-#include <essentiautil.h>
-#include <complex>
+#include <map>
+#include <stdexcept>
+#include <mutex>
+#include <tuple>
 
 using namespace NdkEssentiaEmbedding;
-using namespace essentia;
-using namespace essentia::standard;
 
-using EssentiaComplex = std::complex<Real>;
+namespace {
+    // CSR 형식 Chroma 필터뱅크: k 번째 chroma 의 가중치는 [rowStart[k], rowStart[k+1]) 구간 (bin 오름차순)
+    struct ChromaFilterBank {
+        std::vector<int> rowStart;
+        std::vector<int> bins;
+        std::vector<float> weights;
+    };
 
-std::vector<std::vector<float>> EmbeddingHelper::computeChroma(
-        const std::vector<float> &audio,
-        const EmbeddingConfig &config
-) {
-    // Chroma 추출 시간 측정
-    RunTimerLogger timer("Extract Chroma");
-    // 1. 파라미터 (Librosa CQT와 유사성을 위해 8192 권장)
-    int frameSize = 8192;
-    int hopSize = 512;
-    int sampleRate = config.sr;
-    int chromaBins = config.chroma_bins; // 12
-
-    // 2. Essentia 알고리즘 생성
-    AlgorithmFactory& factory = AlgorithmFactory::instance();
-    Algorithm* windowing = factory.create("Windowing", "type", "hann", "size", frameSize);
-    Algorithm* spectrum = factory.create("Spectrum", "size", frameSize);
+    std::shared_ptr<const ChromaFilterBank> buildChromaFilterBank(int sampleRate, int frameSize, int chromaBins) {
+        int spectrumSize = frameSize / 2 + 1;
+        std::vector<std::vector<float>> dense(chromaBins, std::vector<float>(spectrumSize, 0.0f));
 
-    std::vector<Real> frame(frameSize);
-    std::vector<Real> windowedFrame;
-    std::vector<Real> spectrumData;
+        float freqResolution = (float)sampleRate / frameSize;
+        float refFreq = 440.0f;
+        float width = 1.0f; // Librosa 기본값과 유사한 확산 정도
 
-    windowing->input("frame").set(frame);
-    windowing->output("frame").set(windowedFrame);
-    spectrum->input("frame").set(windowedFrame);
-    spectrum->output("spectrum").set(spectrumData);
+        for (int bin = 0; bin < spectrumSize; ++bin) {
+            float freq = bin * freqResolution;
+            if (freq < 32.7f) continue; // C1 미만 무시
 
-    // 3. Gaussian Filter Bank 미리 계산
-    int spectrumSize = frameSize / 2 + 1;
-    std::vector<std::vector<float>> filterBank(chromaBins, std::vector<float>(spectrumSize, 0.0f));
+            float midiNote = 69 + 12 * std::log2(freq / refFreq);
 
-    float freqResolution = (float)sampleRate / frameSize;
-    float refFreq = 440.0f;
-    float width = 1.0f; // Librosa 기본값과 유사한 확산 정도
+            for (int k = 0; k < chromaBins; ++k) {
+                float dist = std::fmod(midiNote - k, 12.0f);
+                if (dist < -6.0f) dist += 12.0f;
+                if (dist > 6.0f) dist -= 12.0f;
 
-    for (int bin = 0; bin < spectrumSize; ++bin) {
-        float freq = bin * freqResolution;
-        if (freq < 32.7f) continue; // C1 미만 무시
+                float weight = std::exp(-0.5f * std::pow(dist / width, 2));
 
-        float midiNote = 69 + 12 * std::log2(freq / refFreq);
+                // 가우시안 필터 적용 (Thresholding으로 속도 최적화)
+                if (weight > 0.01f) {
+                    dense[k][bin] += weight;
+                }
+            }
+        }
 
+        // 밀집 -> CSR 압축
+        auto bank = std::make_shared<ChromaFilterBank>();
+        bank->rowStart.reserve(chromaBins + 1);
+        bank->rowStart.push_back(0);
         for (int k = 0; k < chromaBins; ++k) {
-            float dist = std::fmod(midiNote - k, 12.0f);
-            if (dist < -6.0f) dist += 12.0f;
-            if (dist > 6.0f) dist -= 12.0f;
-
-            float weight = std::exp(-0.5f * std::pow(dist / width, 2));
-
-            // 가우시안 필터 적용 (Thresholding으로 속도 최적화)
-            if (weight > 0.01f) {
-                filterBank[k][bin] += weight;
+            for (int bin = 0; bin < spectrumSize; ++bin) {
+                if (dense[k][bin] > 0.0f) {
+                    bank->bins.push_back(bin);
+                    bank->weights.push_back(dense[k][bin]);
+                }
             }
+            bank->rowStart.push_back(static_cast<int>(bank->bins.size()));
         }
+        return bank;
     }
 
-    // 4. 처리 루프
-    std::vector<std::vector<float>> chromagram(chromaBins);
-    int estimatedFrames = (audio.size() - frameSize) / hopSize + 1;
-    if (estimatedFrames > 0) {
-        for (auto& row : chromagram) row.reserve(estimatedFrames);
+    // (sampleRate, frameSize, chromaBins) 별로 1회만 생성하여 프로세스 전체에서 공유
+    std::shared_ptr<const ChromaFilterBank> getChromaFilterBank(int sampleRate, int frameSize, int chromaBins) {
+        static std::mutex mutex;
+        static std::map<std::tuple<int, int, int>, std::shared_ptr<const ChromaFilterBank>> cache;
+
+        const auto key = std::make_tuple(sampleRate, frameSize, chromaBins);
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& bank = cache[key];
+        if (!bank) {
+            bank = buildChromaFilterBank(sampleRate, frameSize, chromaBins);
+        }
+        return bank;
     }
+}
+
+FeatureTensor EmbeddingHelper::computeChroma(
+        AudioView audio,
+        const EmbeddingConfig &config
+) {
+    FeatureTensor chromagram;
+    computeChroma(audio, config, chromagram);
+    return chromagram;
+}
 
-    if (audio.size() >= frameSize) {
-        for (size_t i = 0; i + frameSize <= audio.size(); i += hopSize) {
+void EmbeddingHelper::computeChroma(
+        AudioView audio,
+        const EmbeddingConfig &config,
+        FeatureTensor &out
+) {
+    // Chroma 추출 시간 측정
+    RunTimerLogger timer("Extract Chroma");
+    // 1. 파라미터 (Librosa CQT와 유사성을 위해 8192 권장)
+    int frameSize = 8192;
+    int sampleRate = config.sr;
+    int chromaBins = config.chroma_bins; // 12
 
-            // A. FFT 수행
-            std::copy(audio.begin() + i, audio.begin() + i + frameSize, frame.begin());
-            windowing->compute();
-            spectrum->compute();
+    // 2. 프레임 격자
+    // 텐서 생성 시 LogMel 프레임 수(T) 만큼만 chroma[c][0..T) 를 사용하므로 T 이후 프레임은 계산하지 않음
+    //  - 기본: 기존 격자(hop 512, 패딩 없음)의 앞 T 프레임 (기존 결과와 동일)
+    //  - chroma_at_mel_hop: LogMel 과 같은 hop / center 패딩 격자 (프레임 수와 시각이 LogMel 과 일치)
+    const int melHop = melHopLength(config);
+    const size_t melFrames = StftEngine::frameCount(audio.size(), STFT_N_FFT, melHop, true);
+
+    const int hopSize = config.chroma_at_mel_hop ? melHop : 512;
+    StftEngine& engine = StftEngine::threadLocal(frameSize, hopSize, config.chroma_at_mel_hop);
+    const size_t numFrames = std::min(engine.numFrames(audio.size()), melFrames);
+
+    // 3. Gaussian Filter Bank (설정별 1회 생성, 0 이 아닌 가중치만 CSR 로 보관)
+    std::shared_ptr<const ChromaFilterBank> filterBank = getChromaFilterBank(sampleRate, frameSize, chromaBins);
+
+    // 4. 출력 [C][T] - 비어있으면 계산할 프레임 수만큼 할당, 준비된 텐서면 그 열 수에 맞춤 (남는 열은 0)
+    if (out.empty() && out.data() == nullptr) {
+        out = FeatureTensor(chromaBins, numFrames);
+    } else if (out.rows() != static_cast<size_t>(chromaBins)) {
+        throw std::invalid_argument("Chroma output rows mismatch : " + std::to_string(out.rows()));
+    }
+    const size_t framesToWrite = std::min(numFrames, out.cols());
+    for (int k = 0; k < chromaBins; ++k) {
+        std::fill(out.row(k) + framesToWrite, out.row(k) + out.cols(), 0.0f);
+    }
 
-            // B. Filter Bank 적용 (Spectrum -> Chroma)
-            std::vector<float> currentFrame(chromaBins, 0.0f);
-            float maxVal = 0.0f; // 정규화를 위한 최댓값 찾기
+    // 5. 처리 루프
 
-            for (int k = 0; k < chromaBins; ++k) {
-                float energy = 0.0f;
-                const std::vector<float>& filters = filterBank[k];
+    std::vector<float> spectrumData(engine.numBins());
+    std::vector<float> currentFrame(chromaBins, 0.0f);
 
-                for (int bin = 0; bin < spectrumSize; ++bin) {
-                    if (filters[bin] > 0.0f) {
-                        energy += filters[bin] * spectrumData[bin];
-                    }
-                }
-                currentFrame[k] = energy;
+    for (size_t t = 0; t < framesToWrite; ++t) {
 
-                // 최댓값 갱신
-                if (energy > maxVal) maxVal = energy;
-            }
+        // A. FFT 수행 (Hann 윈도우 + 크기 스펙트럼, Essentia Windowing -> Spectrum 과 동일)
+        engine.computeFrame(audio.data(), audio.size(), t, SpectrumType::Magnitude, spectrumData.data());
 
-            // C. [핵심] Max Normalization (Librosa 기본 동작 구현)
-            // 최댓값으로 나누어 0~1 사이로 스케일링
-            if (maxVal < 1e-9f) maxVal = 1.0f; // 0 나누기 방지
+        // B. Filter Bank 적용 (Spectrum -> Chroma)
+        float maxVal = 0.0f; // 정규화를 위한 최댓값 찾기
 
-            for (int k = 0; k < chromaBins; ++k) {
-                chromagram[k].push_back(currentFrame[k] / maxVal);
+        for (int k = 0; k < chromaBins; ++k) {
+            // 희소 내적 (bin 오름차순 - 기존 밀집 루프와 합산 순서 동일)
+            float energy = 0.0f;
+            const int rowEnd = filterBank->rowStart[k + 1];
+            for (int j = filterBank->rowStart[k]; j < rowEnd; ++j) {
+                energy += filterBank->weights[j] * spectrumData[filterBank->bins[j]];
             }
+            currentFrame[k] = energy;
+
+            // 최댓값 갱신
+            if (energy > maxVal) maxVal = energy;
         }
-    }
 
-    delete windowing;
-    delete spectrum;
+        // C. [핵심] Max Normalization (Librosa 기본 동작 구현)
+        // 최댓값으로 나누어 0~1 사이로 스케일링
+        if (maxVal < 1e-9f) maxVal = 1.0f; // 0 나누기 방지
 
-    return chromagram;
-}
\ No newline at end of file
+        for (int k = 0; k < chromaBins; ++k) {
+            out(k, t) = currentFrame[k] / maxVal;
+        }
+    }
+}
@@ -4,67 +4,133 @@
 //
 
 #include "embedding_helper.h"
+#include "common/worker_pool.h"
+#include "feature/stft_engine.h"
+#include "onnx/inference_batch.h"
 #include <stdexcept>
 #include <algorithm> // std::copy 사용
 
 using namespace NdkEssentiaEmbedding;
 
 FullFeatures EmbeddingHelper::extractFeatures(
-        const std::vector<float>& audio,
-        const EmbeddingConfig& config
+        AudioView audio,
+        const EmbeddingConfig& config,
+        WorkerPool* pool
+) {
+    // 특징마다 연속 텐서 1개 (추출기가 할당)
+    FullFeatures features;
+    extractFeatures(audio, config, features, pool);
+    return features;
+}
+
+void EmbeddingHelper::extractFeatures(
+        AudioView audio,
+        const EmbeddingConfig& config,
+        FullFeatures& features,
+        WorkerPool* pool
 ) {
     // 시간 측정
     RunTimerLogger timer("extractFeatures Function");
 
-    // Python 코드의 반환 형태와 동일하게 구성 (key: 특징 이름, value: 특징 데이터)
-    FullFeatures features;
+    // features 의 텐서가 비어있으면 추출기가 할당, 준비된 텐서(배치 슬롯 뷰)면 그 자리에 기록
 
-    // --- 1. HPSS 분리 신호 준비 (y_h, y_p) ---
-    std::vector<float> y_h; // Harmonic (크로마 추출용)
-    std::vector<float> y_p; // Percussive (템포 추출용)
+    // 태스크 그래프
+    //  - STFT(원본) 1회 -> LogMel, Tempo(HPSS 미사용 시) 가 공유
+    //  - HPSS(선택) -> Chroma(y_h), Tempo(y_p)
+    // (pool 이 없으면 호출 순서대로 순차 수행)
+    TaskGroup group(pool);
 
     if (config.use_hpss) {
-        // HPSS 수행
+        // --- 1. Log-Mel 추출 (원본 오디오 y 의 STFT 사용) - HPSS 와 병렬 ---
+        group.run([&]() { computeLogMel(computeStft(audio, config), config, features.mel); });
+
+        // --- 2. HPSS 분리 신호 준비 (y_h, y_p) - 호출 스레드에서 수행 ---
+        std::vector<float> y_h; // Harmonic (크로마 추출용)
+        std::vector<float> y_p; // Percussive (템포 추출용)
         performHPSS(audio, y_h, y_p);
+
+        // --- 3. Chroma CQT 추출 (고조파 신호 y_h 사용) ---
+        group.run([&]() { computeChroma(y_h, config, features.chroma); });
+
+        // --- 4. Tempo Vector 추출 (타악기 신호 y_p 사용 - 별도 STFT) ---
+        group.run([&]() { computeTempo(computeStft(y_p, config), config, features.tempo); });
+
+        group.wait();
     } else {
-        // HPSS를 사용하지 않으면 원본 신호를 복사
-        y_h = audio;
-        y_p = audio;
+        // HPSS 를 사용하지 않으면 Chroma / Tempo 모두 원본 신호 사용
+
+        // --- 1. Chroma CQT 추출 (원본 신호, 별도 프레임 크기) - STFT 와 병렬 ---
+        group.run([&]() { computeChroma(audio, config, features.chroma); });
+
+        // --- 2. 공유 STFT (호출 스레드에서 수행) ---
+        Spectrogram stft = computeStft(audio, config);
+
+        if (config.onset_from_logmel) {
+            // --- 3. Log-Mel 추출 후 같은 Log-Mel 로 Tempo 추출 (Mel 투영 1회) ---
+            computeLogMel(stft, config, features.mel);
+            computeTempo(features.mel, config, features.tempo);
+        } else {
+            // --- 3. Log-Mel / Tempo 추출 (같은 STFT 의 파워 / 크기 스펙트럼 사용) ---
+            group.run([&]() { computeLogMel(stft, config, features.mel); });
+            group.run([&]() { computeTempo(stft, config, features.tempo); });
+        }
+
+        group.wait();
     }
 
-    // --- 2. Log-Mel 추출 ---
-    // (원본 오디오 y를 사용)
-    std::vector<std::vector<float>> mel = computeLogMel(audio, config);
-    if (!mel.empty()) {
-        features["mel"] = std::move(mel);
-    } else {
+    if (features.mel.empty()) {
         LOGW("mel 이 비어있음");
     }
-
-    // --- 3. Chroma CQT 추출 ---
-    // (고조파 신호 y_h를 사용)
-    std::vector<std::vector<float>> chroma = computeChroma(y_h, config);
-    if (!chroma.empty()) {
-        features["chroma"] = std::move(chroma);
-    } else {
+    if (features.chroma.empty()) {
         LOGW("chroma 가 비어있음");
     }
+    if (features.tempo.empty()) {
+        LOGW("tempo 가 비어있음");
+    }
+}
 
-    // --- 4. Tempo Vector 추출 ---
-    // (타악기 신호 y_p를 사용)
-    std::vector<float> tempo_vec = computeTempo(y_p, config);
+std::vector<FullFeatures> EmbeddingHelper::extractAllFeatures(
+        const std::vector<AudioView>& segments,
+        const EmbeddingConfig& config,
+        WorkerPool* pool
+) {
+    // 시간 측정
+    RunTimerLogger timer("extractAllFeatures Function");
 
-    // 1D 특징(Tempo)을 FullFeatures 타입(2D: [1][L])으로 변환하여 저장합니다.
-    if (!tempo_vec.empty()) {
-        // **핵심 수정:** std::vector<std::vector<float>>를 명시적으로 생성하여 감쌉니다.
-        std::vector<std::vector<float>> tempo_2d;
-        tempo_2d.reserve(1); // 단일 행만 가짐
-        tempo_2d.push_back(std::move(tempo_vec)); // 1D 벡터를 2D 벡터의 첫 번째 행으로 이동
+    // 세그먼트끼리는 독립적이므로 작업자마다 한 세그먼트씩 처리, 세그먼트 내부의 LogMel/Chroma/Tempo 도 같은 풀에서 병렬 수행
+    // (Essentia 알고리즘 인스턴스와 임시 버퍼는 compute* 호출마다 생성되므로 작업자 간 공유 없음)
+    std::vector<FullFeatures> allSegmentFeatures(segments.size());
+    parallelFor(pool, segments.size(), [&](size_t i) {
+        allSegmentFeatures[i] = extractFeatures(segments[i], config, pool);
+    });
 
-        features["tempo"] = std::move(tempo_2d);
-    } else {
-        LOGW("tempo 가 비어있음");
+    return allSegmentFeatures;
+}
+
+void EmbeddingHelper::extractAllFeatures(
+        const std::vector<AudioView>& segments,
+        const EmbeddingConfig& config,
+        InferenceBatch& batch,
+        WorkerPool* pool
+) {
+    // 시간 측정
+    RunTimerLogger timer("extractAllFeatures Function (batch)");
+
+    if (segments.empty()) {
+        throw std::invalid_argument("No segments to extract features from.");
     }
 
-    return features;
+    // 배치 입력 shape [V,M,T] / [V,C,T] / [V,L] - T 는 LogMel 프레임 수 (세그먼트 길이가 모두 같음)
+    const size_t T = StftEngine::frameCount(segments.front().size(), STFT_N_FFT, melHopLength(config), true);
+    batch.prepare(segments.size(),
+                  static_cast<size_t>(config.mel_n_mels),
+                  static_cast<size_t>(config.chroma_bins),
+                  T,
+                  static_cast<size_t>(std::max(0, config.tempo_win)));
+
+    // 세그먼트마다 자신의 슬롯(입력 버퍼의 뷰)에만 기록하므로 작업자 간 쓰기 충돌 없음
+    parallelFor(pool, segments.size(), [&](size_t i) {
+        FullFeatures slot = batch.slot(i);
+        extractFeatures(segments[i], config, slot, pool);
+    });
 }
\ No newline at end of file
@@ -4,128 +4,113 @@
 //
 
 #include "embedding_helper.h"
-#include <pool.h>
 #include <essentia.h>
+#include <algorithmfactory.h>
+#include <Eigen/Dense>
 #include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
 #include <vector>
 #include <string>
-#include <algorithmfactory.h>
 
 using namespace NdkEssentiaEmbedding;
 using namespace essentia;
 using namespace essentia::standard;
 
-std::vector<std::vector<float>> EmbeddingHelper::computeLogMel(
-        const std::vector<float> &audio,
+namespace {
+    // Mel 필터뱅크 [M][F] (행 우선)
+    using MelBasis = Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+    /**
+     * @brief 설정별 Mel 필터뱅크를 1회만 만들어 프로세스 전체에서 공유.
+     * Essentia MelBands(slaneyMel, unit_sum) 에 단위 임펄스를 하나씩 넣어 열을 추출하므로
+     * 필터 경계 / 정규화가 기존 MelBands 와 정확히 같음 (type=power 는 입력 제곱 후 선형 합이므로 1^2 = 1)
+     */
+    std::shared_ptr<const MelBasis> getMelBasis(const EmbeddingConfig &config, int numBins) {
+        static std::mutex mutex;
+        static std::map<std::tuple<int, int, int>, std::shared_ptr<const MelBasis>> cache;
+
+        const auto key = std::make_tuple(config.sr, config.mel_n_mels, numBins);
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = cache.find(key);
+        if (it != cache.end()) {
+            return it->second;
+        }
+
+        RunTimerLogger timer("Build Mel Basis");
+
+        AlgorithmFactory &factory = AlgorithmFactory::instance();
+        std::unique_ptr<Algorithm> melBands(factory.create("MelBands",
+                                                           "numberBands", config.mel_n_mels,
+                                                           "sampleRate", config.sr,
+                                                           "inputSize", numBins, // 1025
+                                                           "lowFrequencyBound", 0.0f,
+                                                           "highFrequencyBound", config.sr / 2.0f,
+                                                           "normalize","unit_sum", // Librosa 'norm='slaney''
+                                                           "warpingFormula","slaneyMel" // Librosa 'slaneyMel'
+        ));
+
+        std::vector<Real> impulse(numBins, 0.0f), bands;
+        melBands->input("spectrum").set(impulse);
+        melBands->output("bands").set(bands);
+
+        auto basis = std::make_shared<MelBasis>(MelBasis::Zero(config.mel_n_mels, numBins));
+        for (int f = 0; f < numBins; ++f) {
+            impulse[f] = 1.0f;
+            melBands->compute();
+            impulse[f] = 0.0f;
+            for (int m = 0; m < config.mel_n_mels && m < static_cast<int>(bands.size()); ++m) {
+                (*basis)(m, f) = bands[m];
+            }
+        }
+
+        cache[key] = basis;
+        return basis;
+    }
+}
+
+FeatureTensor EmbeddingHelper::computeLogMel(
+        AudioView audio,
         const EmbeddingConfig &config
+) {
+    FeatureTensor melSpectrogram;
+    computeLogMel(computeStft(audio, config), config, melSpectrogram);
+    return melSpectrogram;
+}
+
+void EmbeddingHelper::computeLogMel(
+        const Spectrogram &stft,
+        const EmbeddingConfig &config,
+        FeatureTensor &out
 ) {
     // LogMel 추출 시간 측정
     RunTimerLogger timer("Extract LogMel");
 
-    // --- 1. 파라미터 계산 및 패딩 ---
-
-    // Librosa 기본값
-    const int n_fft = 2048;
-    const int pad_width = n_fft / 2; // 1024
-
-    // Librosa 'center=True' 모방 (제로 패딩)
-    std::vector<Real> padded_audio(pad_width, 0.0f);
-    padded_audio.insert(padded_audio.end(), audio.begin(), audio.end());
-    // resize를 사용하여 후면 패딩 추가
-    padded_audio.resize(padded_audio.size() + pad_width, 0.0f);
-
-    // Python의 int() (절삭)와 일치시키기 위해 static_cast<int> 사용
-    int hopLength = std::max(1, static_cast<int>(config.sr * config.mel_hop_ms / 1000.0f));
-
-    AlgorithmFactory &factory = AlgorithmFactory::instance();
-
-    // --- 2. Essentia 알고리즘 정의 (스마트 포인터 사용) ---
-
-    // FrameCutter: 오디오를 프레임으로 자름
-    std::unique_ptr<Algorithm> frameCutter(factory.create("FrameCutter",
-                                                          "frameSize", n_fft,
-                                                          "hopSize", hopLength,
-                                                          "lastFrameToEndOfFile",false, // Librosa와 일치
-                                                          "startFromZero", true
-    ));
-
-    // Windowing: Hann 윈도우 적용
-    std::unique_ptr<Algorithm> windowing(factory.create("Windowing",
-                                                        "type", "hann"
-    ));
-
-    // PowerSpectrum: Librosa 'power=2.0'과 일치
-    std::unique_ptr<Algorithm> spectrum(factory.create("PowerSpectrum"));
-
-    // MelBands: Mel Filterbank 적용
-    std::unique_ptr<Algorithm> melBands(factory.create("MelBands",
-                                                       "numberBands", config.mel_n_mels,
-                                                       "sampleRate", config.sr,
-                                                       "inputSize", n_fft / 2 + 1, // 1025
-                                                       "lowFrequencyBound", 0.0f,
-                                                       "highFrequencyBound", config.sr / 2.0f,
-                                                       "normalize","unit_sum", // Librosa 'norm='slaney''
-                                                       "warpingFormula","slaneyMel" // Librosa 'slaneyMel'
-    ));
-
-    // --- 3. 출력 벡터 [M][T] 준비 ---
-    size_t M = config.mel_n_mels;
-    std::vector<std::vector<float>> melSpectrogram(M);
-
-    // 성능 최적화: T의 길이를 추정하여 미리 공간 할당
-    size_t estimated_T = padded_audio.size() / hopLength + 1;
-    for (size_t i = 0; i < M; ++i) {
-        melSpectrogram[i].reserve(estimated_T);
+    const size_t M = config.mel_n_mels;
+    const size_t T = stft.numFrames;
+    out.ensureShape(M, T); // [M][T]
+    if (out.empty()) {
+        return;
     }
 
-    // --- 4. 임시 버퍼 ---
-    std::vector<Real> frame, windowedFrame, spec, melBandsOut;
-
-    // --- 5. 알고리즘 파이프라인 수동 설정 (루프용) ---
-    frameCutter->input("signal").set(padded_audio); // 패딩된 오디오 사용
-    frameCutter->output("frame").set(frame);
+    // --- 1. Mel 필터뱅크 [M][F] (설정별 1회 생성) ---
+    std::shared_ptr<const MelBasis> basis = getMelBasis(config, static_cast<int>(stft.numBins));
 
-    windowing->input("frame").set(frame);
-    windowing->output("frame").set(windowedFrame);
+    // --- 2. 전체 프레임 Mel 투영을 한 번의 행렬 곱으로 수행 ---
+    // 공유 STFT 파워 스펙트럼 [T][F] 를 복사 없이 매핑
+    using RowMajorMatrix = Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+    Eigen::Map<const RowMajorMatrix> power(stft.power.data(), T, stft.numBins);
 
-    spectrum->input("signal").set(windowedFrame);
-    spectrum->output("powerSpectrum").set(spec);
+    // 출력 텐서 [M][T] (행 간격 stride) 에 바로 기록
+    Eigen::Map<RowMajorMatrix, Eigen::Unaligned, Eigen::OuterStride<>> mel(
+            out.data(), M, T, Eigen::OuterStride<>(static_cast<Eigen::Index>(out.stride())));
 
-    melBands->input("spectrum").set(spec);
-    melBands->output("bands").set(melBandsOut);
+    // MelBands(type=power) 와 동일하게 입력을 제곱한 뒤 투영: [M][F] x [F][T] = [M][T]
+    mel.noalias() = (*basis) * power.array().square().matrix().transpose();
 
-    // --- 6. 프레임 단위 계산 루프 ---
-    while (true) {
-        // FrameCutter 실행
-        frameCutter->compute();
-
-        // 프레임이 비어있으면(신호의 끝) 루프 종료
-        if (frame.empty()) {
-            break;
-        }
-
-        // Windowing -> PowerSpectrum -> MelBands 순차 실행
-        windowing->compute();
-        spectrum->compute();
-        melBands->compute();
-
-        // --- 7. 수동 PowerToDB 및 [M][T] 저장 ---
-        // (Python: librosa.power_to_db(S + 1e-10))
-        for (int m_idx = 0; m_idx < M; ++m_idx) {
-
-            // 1. 음수 값을 0.0f로 클리핑(clipping) (PowerSpectrum 결과는 이론상 음수가 없지만 안전장치)
-            float value = std::max(0.0f, melBandsOut[m_idx]);
-
-            // 2. 0 또는 양수 값에 Epsilon(1e-10)을 더하고 로그 계산
-            // (Python의 `S + 1e-10` 로직과 정확히 일치)
-            float logMelValue = 10.0f * std::log10(value + 1e-10f);
-
-            // [M][T] 형식으로 저장
-            melSpectrogram[m_idx].push_back(logMelValue);
-        }
-    }
-
-    // 스마트 포인터를 사용하므로 수동 delete가 필요 없습니다.
-
-    return melSpectrogram;
-}
\ No newline at end of file
+    // --- 3. PowerToDB (벡터화, 제자리) ---
+    // (Python: librosa.power_to_db(S + 1e-10), 음수는 0 으로 클리핑)
+    mel = (10.0f * (mel.array().max(0.0f) + 1e-10f).log10()).matrix();
+}
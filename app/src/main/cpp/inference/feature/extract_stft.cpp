@@ -0,0 +1,38 @@
+//
+// Created by glion on 2025-12-05.
+// 한 세그먼트에 대해 STFT 파워 스펙트럼 추출 (LogMel / Tempo 공유 프론트엔드)
+//
+
+#include "embedding_helper.h"
+#include "feature/stft_engine.h"
+#include <algorithm>
+#include <vector>
+
+using namespace NdkEssentiaEmbedding;
+
+Spectrogram EmbeddingHelper::computeStft(
+        AudioView audio,
+        const EmbeddingConfig &config
+) {
+    // STFT 시간 측정
+    RunTimerLogger timer("Extract STFT");
+
+    // Librosa 기본값
+    const int n_fft = STFT_N_FFT;
+
+    int hopLength = melHopLength(config);
+
+    // Essentia FrameCutter -> Windowing(hann) -> PowerSpectrum 체인과 동일한 결과를 한 루프에서 계산
+    // Librosa 'center=True' 제로 패딩은 복사 없이 가상으로 처리
+    StftEngine& engine = StftEngine::threadLocal(n_fft, hopLength, true);
+
+    // 출력 [T][F] 를 한 번에 할당
+    Spectrogram stft;
+    stft.numBins = engine.numBins(); // 1025
+    stft.numFrames = engine.numFrames(audio.size());
+    stft.power.resize(stft.numFrames * stft.numBins);
+
+    engine.compute(audio.data(), audio.size(), SpectrumType::Power, stft.power.data(), stft.numFrames);
+
+    return stft;
+}
@@ -4,6 +4,7 @@
 //
 
 #include "embedding_helper.h"
+#include "feature/stft_engine.h"
 #include <pool.h>
 #include <essentia.h>
 #include <cmath>
@@ -11,173 +12,191 @@
 #include <algorithmfactory.h>
 #include <numeric>
 #include <algorithm>
+#include <Eigen/Dense>
 
 using namespace NdkEssentiaEmbedding;
 using namespace essentia;
 using namespace essentia::standard;
 
-using EssentiaComplex = std::complex<Real>;
+namespace {
+    // Librosa 'tempogram' 기본 win_length (hop_length = 1)
+    constexpr int TEMPOGRAM_WIN_LENGTH = 384;
+}
 
-std::vector<float> EmbeddingHelper::computeTempo(
-        const std::vector<float> &audio,
+std::vector<float> EmbeddingHelper::meanTempogram(
+        const std::vector<float> &onset,
+        int winLength,
+        int numLags
+) {
+    std::vector<float> histogram(std::max(0, numLags), 0.0f);
+    meanTempogram(onset, winLength, numLags, histogram.data());
+    return histogram;
+}
+
+void EmbeddingHelper::meanTempogram(
+        const std::vector<float> &onset,
+        int winLength,
+        int numLags,
+        float* histogram
+) {
+    // 기존 방식: 길이 winLength, hop 1 인 모든 프레임(FrameCutter, 완전한 프레임만)마다
+    //   r_s[l] = sum_{j=0}^{winLength-1-l} x[s+j] * x[s+j+l]   (AutoCorrelation, standard)
+    // 을 구해 프레임 수 K 로 평균. 곱 x[i] * x[i+l] 이 포함되는 프레임 수만 알면 되므로
+    //   sum_s r_s[l] = sum_i x[i] * x[i+l] * count_l(i),
+    //   count_l(i) = |{ s in [0, K) : i - (winLength-1-l) <= s <= i }|
+    // 로 lag 당 O(N) 에 계산 (반환하는 lag 만, 2D 템포그램 없이)
+    std::fill(histogram, histogram + std::max(0, numLags), 0.0f);
+
+    const long long n = static_cast<long long>(onset.size());
+    const long long frames = static_cast<long long>(StftEngine::frameCount(onset.size(), winLength, 1, false));
+    if (frames == 0) {
+        return; // 프레임이 없으면 0-벡터 (기존과 동일)
+    }
+
+    const int lags = std::min(numLags, winLength); // winLength 이후 lag 은 0 (기존: [384] -> resize)
+    for (int l = 0; l < lags; ++l) {
+        const long long span = winLength - 1 - l; // 프레임 내에서 x[j] 가 가질 수 있는 최대 위치
+        const long long last = std::min(n - 1 - l, frames - 1 + span);
+        double sum = 0.0;
+        for (long long i = 0; i <= last; ++i) {
+            const long long count = std::min(frames - 1, i) - std::max(0LL, i - span) + 1;
+            sum += static_cast<double>(onset[i]) * onset[i + l] * count;
+        }
+        histogram[l] = static_cast<float>(sum / frames);
+    }
+}
+
+FeatureTensor EmbeddingHelper::computeTempo(
+        AudioView audio,
         const EmbeddingConfig &config
 ) {
+    FeatureTensor tempo;
+    computeTempo(computeStft(audio, config), config, tempo);
+    return tempo;
+}
+
+void EmbeddingHelper::computeTempo(
+        const Spectrogram &stft,
+        const EmbeddingConfig &config,
+        FeatureTensor &out
+) {
+    // LogMel 기반 onset 이 설정된 경우 같은 STFT 로 LogMel 을 만들어 사용
+    if (config.onset_from_logmel) {
+        FeatureTensor logMel;
+        computeLogMel(stft, config, logMel);
+        computeTempo(logMel, config, out);
+        return;
+    }
+
     // Tempo 시간 측정
     RunTimerLogger timer("Extract Tempo");
 
-    Real sampleRate = static_cast<Real>(config.sr);
-    int tempoWin = config.tempo_win; // Python의 tempo_win (160)
+    // --- 1. Onset Novelty Curve 생성 (Python의 onset_env) ---
+    std::vector<float> onsetNoveltyCurve = computeOnsetEnvelope(stft, config);
+
+    // --- 2. 시간 평균 Tempogram ---
+    tempoFromOnset(onsetNoveltyCurve, config, out);
+}
+
+void EmbeddingHelper::computeTempo(
+        const FeatureTensor &logMel,
+        const EmbeddingConfig &config,
+        FeatureTensor &out
+) {
+    // Tempo 시간 측정
+    RunTimerLogger timer("Extract Tempo (LogMel onset)");
+
+    // --- 1. Onset Novelty Curve 생성 (이미 계산된 LogMel 사용) ---
+    std::vector<float> onsetNoveltyCurve = computeOnsetEnvelope(logMel, config);
+
+    // --- 2. 시간 평균 Tempogram ---
+    tempoFromOnset(onsetNoveltyCurve, config, out);
+}
+
+void EmbeddingHelper::tempoFromOnset(
+        const std::vector<float> &onset,
+        const EmbeddingConfig &config,
+        FeatureTensor &out
+) {
+    int tempoWin = std::max(0, config.tempo_win); // Python의 tempo_win (160)
+    out.ensureShape(1, tempoWin); // [1][L]
+    if (out.empty()) {
+        return;
+    }
+
+    // (Python: T = librosa.feature.tempogram(onset_envelope=onset_env, ...); T.mean(axis=1))
+    // 2D 템포그램을 만들지 않고, 반환할 tempoWin 개 lag 만 직접 계산
+    meanTempogram(onset, TEMPOGRAM_WIN_LENGTH, tempoWin, out.row(0));
+}
 
-    // [T-Align] 홉 길이 (LogMel과 동일)
-    int hopLength = std::max(1, static_cast<int>(sampleRate * config.mel_hop_ms / 1000.0f));
+std::vector<float> EmbeddingHelper::computeOnsetEnvelope(
+        const Spectrogram &stft,
+        const EmbeddingConfig &config
+) {
+    Real sampleRate = static_cast<Real>(config.sr);
 
     AlgorithmFactory &factory = AlgorithmFactory::instance();
 
-    // --- 1. Onset Novelty Curve 생성 (Python의 onset_env) ---
-    // (이 로직은 이전과 동일하며, 올바르게 동작합니다)
-
-    const int frameSize = 2048;
-    const int pad_width = frameSize / 2;
-    std::vector<Real> padded_audio(pad_width, 0.0f);
-    padded_audio.insert(padded_audio.end(), audio.begin(), audio.end());
-    padded_audio.resize(padded_audio.size() + pad_width, 0.0f);
-
-    std::unique_ptr<Algorithm> onsetFrameCutter(
-            factory.create("FrameCutter",
-                           "frameSize", frameSize, "hopSize", hopLength,
-                           "lastFrameToEndOfFile", false, "startFromZero", true));
-    std::unique_ptr<Algorithm> windowing(
-            factory.create("Windowing", "type", "hann", "size", frameSize));
-    std::unique_ptr<Algorithm> fft(factory.create("FFT"));
+    // STFT(n_fft 2048, hop = LogMel 과 동일, Hann) 는 공유 프론트엔드에서 계산된 파워 스펙트럼을 사용
+    // 크기 스펙트럼 = sqrt(파워 스펙트럼) - 위상(atan2)은 계산하지 않음
+
     std::unique_ptr<Algorithm> onsetDetection(
             factory.create("OnsetDetection", "method", "melflux", "sampleRate", sampleRate));
 
-    std::vector<Real> frame, windowedFrame;
-    std::vector<EssentiaComplex> complexSpectrum;
-    std::vector<Real> magnitudeSpectrum, phaseSpectrum;
+    // melflux 는 위상을 사용하지 않으므로 위상 입력은 0으로 고정 (알고리즘 입력 연결용으로 1회만 할당)
+    std::vector<Real> magnitudeSpectrum(stft.numBins), phaseSpectrum(stft.numBins, 0.0f);
     Real currentOnsetStrength = 0.0;
     std::vector<Real> onsetNoveltyCurve; // 1D Onset Envelope [T]
+    onsetNoveltyCurve.reserve(stft.numFrames);
 
-    onsetFrameCutter->input("signal").set(padded_audio);
-    onsetFrameCutter->output("frame").set(frame);
-    windowing->input("frame").set(frame);
-    windowing->output("frame").set(windowedFrame);
-    fft->input("frame").set(windowedFrame);
-    fft->output("fft").set(complexSpectrum);
     onsetDetection->input("spectrum").set(magnitudeSpectrum);
     onsetDetection->input("phase").set(phaseSpectrum);
     onsetDetection->output("onsetDetection").set(currentOnsetStrength);
 
-    while (true) {
-        onsetFrameCutter->compute();
-        if (frame.empty()) break;
-        windowing->compute();
-        fft->compute();
-        if (complexSpectrum.empty()) continue;
-
-        magnitudeSpectrum.resize(complexSpectrum.size());
-        std::transform(complexSpectrum.begin(), complexSpectrum.end(),
-                       magnitudeSpectrum.begin(),
-                       [](const EssentiaComplex& c){ return std::abs(c); });
-        phaseSpectrum.resize(complexSpectrum.size());
-        std::transform(complexSpectrum.begin(), complexSpectrum.end(),
-                       phaseSpectrum.begin(),
-                       [](const EssentiaComplex& c){ return std::arg(c); });
+    Eigen::Map<Eigen::ArrayXf> magnitude(magnitudeSpectrum.data(), stft.numBins);
+    for (size_t t = 0; t < stft.numFrames; ++t) {
+        // 벡터화된 sqrt (프레임 단위)
+        magnitude = Eigen::Map<const Eigen::ArrayXf>(stft.frame(t), stft.numBins).sqrt();
 
         onsetDetection->compute();
         onsetNoveltyCurve.push_back(currentOnsetStrength);
     }
 
-    // --- 2. [수정] 수동 Tempogram 계산 (Windowed Auto-Correlation) ---
-    // (Python: T = librosa.feature.tempogram(onset_envelope=onset_env, ...))
-
-    // Librosa의 'tempogram' 기본 win_length
-    const int num_lags = 384; // (Librosa 'tempogram' 기본 win_length)
-    // Librosa의 'tempogram' 기본 hop_length (1)
-    const int tempogram_hop_length = 1;
-
-    // 2.1 1D 'onsetNoveltyCurve'를 자르기 위한 두 번째 FrameCutter
-    std::unique_ptr<Algorithm> tempoFrameCutter(
-            factory.create("FrameCutter",
-                           "frameSize", num_lags, // 384
-                           "hopSize", tempogram_hop_length,   // 1
-                           "lastFrameToEndOfFile", false,
-                           "startFromZero", true
-            ));
-
-    // 2.2 자기상관(Autocorrelation) 알고리즘
-    std::unique_ptr<Algorithm> autoCorrelationAlgo(factory.create("AutoCorrelation"));
-
-    // 버퍼
-    std::vector<Real> onset_frame;      // 1D 온셋 프레임 [384]
-    std::vector<Real> autocorr_vec;   // 1D 자기상관 결과 [384]
-    std::vector<std::vector<Real>> tempogram2D; // 2D 템포그램 [384][Time]
-
-    // (성능 최적화: 2D 벡터 미리 할당)
-    size_t estimated_T = onsetNoveltyCurve.size() / tempogram_hop_length + 1;
-    tempogram2D.reserve(estimated_T);
-
-    // 알고리즘 연결
-    tempoFrameCutter->input("signal").set(onsetNoveltyCurve);
-    tempoFrameCutter->output("frame").set(onset_frame);
-
-    autoCorrelationAlgo->input("array").set(onset_frame);
-    autoCorrelationAlgo->output("autoCorrelation").set(autocorr_vec);
-
-    // 2.3 Windowed Auto-Correlation 루프
-    while (true) {
-        tempoFrameCutter->compute();
-        if (onset_frame.empty()) {
-            break;
-        }
+    return onsetNoveltyCurve;
+}
 
-        autoCorrelationAlgo->compute();
-
-        // 2D 템포그램 생성
-        tempogram2D.push_back(autocorr_vec);
+std::vector<float> EmbeddingHelper::computeOnsetEnvelope(
+        const FeatureTensor &logMel,
+        const EmbeddingConfig &config
+) {
+    // librosa.onset.onset_strength(S=power_to_db(mel)) 와 같은 방식
+    //  onset[t] = mean_m max(0, S[m][t] - S[m][t-1]),  S 는 top_db(80) 로 하한 클리핑
+    //  center=True 보정을 위해 앞쪽 (1 + n_fft / (2 * hop)) 프레임은 0, 길이는 T 로 맞춤
+    const size_t M = logMel.rows();
+    const size_t T = logMel.cols();
+    std::vector<float> onset(T, 0.0f);
+    if (M == 0 || T < 2) {
+        return onset;
     }
 
-    // --- 3. 2D 템포그램을 1D로 평균 (Python: T.mean(axis=1)) ---
-    std::vector<float> tempo_histogram_1d(num_lags, 0.0f); // 1D 템포 벡터 [384] (float으로 바로 선언)
-
-    size_t num_frames = tempogram2D.size(); // T (시간 축)
-
-    if (num_frames > 0) {
-        // 3.1 모든 프레임의 값을 'lag'별로 더합니다 (열(column) 합계).
-        for (size_t t = 0; t < num_frames; ++t) {
-            // (안전 장치: 모든 autocorr_vec의 크기가 num_lags(384)라고 가정)
-            if (tempogram2D[t].size() == num_lags) {
-                for (int l = 0; l < num_lags; ++l) {
-                    tempo_histogram_1d[l] += tempogram2D[t][l];
-                }
-            }
-        }
-
-        // 3.2 합계를 프레임 수(T)로 나누어 평균을 구합니다.
-        for (int l = 0; l < num_lags; ++l) {
-            tempo_histogram_1d[l] /= num_frames;
-        }
+    // top_db 하한 (librosa power_to_db 기본 top_db = 80)
+    float maxDb = -INFINITY;
+    for (size_t m = 0; m < M; ++m) {
+        maxDb = std::max(maxDb, *std::max_element(logMel.row(m), logMel.row(m) + T));
     }
+    const float floorDb = maxDb - 80.0f;
 
-
-    // --- 4. 패딩/슬라이싱 (Python 로직과 100% 동일) ---
-    // (이 로직은 이전 코드에서도 완벽했습니다)
-
-    std::vector<float> finalTempoVector;
-
-    if (tempo_histogram_1d.empty()) {
-        finalTempoVector.assign(tempoWin, 0.0f); // 실패 시 0-벡터
-        return finalTempoVector;
+    // 밴드별 양의 차분을 프레임 축으로 누적 (행 단위 벡터화)
+    Eigen::ArrayXf flux = Eigen::ArrayXf::Zero(T - 1);
+    for (size_t m = 0; m < M; ++m) {
+        Eigen::Map<const Eigen::ArrayXf> s(logMel.row(m), T);
+        flux += (s.tail(T - 1).max(floorDb) - s.head(T - 1).max(floorDb)).max(0.0f);
     }
+    flux /= static_cast<float>(M);
 
-    // Librosa 로직: [384] -> [160] (자르기)
-    if (tempo_histogram_1d.size() >= tempoWin) {
-        finalTempoVector.assign(tempo_histogram_1d.begin(), tempo_histogram_1d.begin() + tempoWin);
-    } else {
-        // (이 케이스는 librosa 기본값(384 > 160) 하에서는 거의 발생하지 않음)
-        finalTempoVector.assign(tempo_histogram_1d.begin(), tempo_histogram_1d.end());
-        finalTempoVector.resize(tempoWin, 0.0f);
+    const size_t shift = 1 + static_cast<size_t>(STFT_N_FFT / (2 * melHopLength(config)));
+    for (size_t t = shift; t < T; ++t) {
+        onset[t] = flux[t - shift];
     }
-
-    return finalTempoVector;
-}
\ No newline at end of file
+    return onset;
+}
@@ -0,0 +1,99 @@
+//
+// Created by glion on 2025-12-08.
+// 할당 없는(allocation-free) STFT 커널 구현
+//
+
+#include "feature/stft_engine.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <tuple>
+
+using namespace NdkEssentiaEmbedding;
+
+StftEngine::StftEngine(int nFft, int hop, bool center)
+        : m_nFft(nFft),
+          m_hop(std::max(1, hop)),
+          m_pad(center ? nFft / 2 : 0),
+          m_window(nFft),
+          m_frame(nFft),
+          m_spectrum(nFft / 2 + 1) {
+    // Essentia 'hann' (대칭형): 0.5 - 0.5 * cos(2*pi*i / (N-1))
+    double sum = 0.0;
+    for (int i = 0; i < nFft; ++i) {
+        m_window[i] = static_cast<float>(0.5 - 0.5 * std::cos((2.0 * M_PI * i) / (nFft - 1.0)));
+        sum += m_window[i];
+    }
+    // Essentia normalized=true: 음의 주파수 에너지를 고려해 합이 2 가 되도록 스케일
+    if (sum > 0.0) {
+        const float scale = static_cast<float>(2.0 / sum);
+        for (float& w : m_window) w *= scale;
+    }
+
+    // 실수 입력 -> 절반 스펙트럼(nFft/2 + 1), 스케일 없음 (Essentia FFT 와 동일)
+    m_fft.SetFlag(Eigen::FFT<float>::HalfSpectrum);
+}
+
+StftEngine& StftEngine::threadLocal(int nFft, int hop, bool center) {
+    thread_local std::map<std::tuple<int, int, bool>, std::unique_ptr<StftEngine>> engines;
+    auto& engine = engines[std::make_tuple(nFft, hop, center)];
+    if (!engine) {
+        engine = std::make_unique<StftEngine>(nFft, hop, center);
+    }
+    return *engine;
+}
+
+size_t StftEngine::frameCount(size_t numSamples, int nFft, int hop, bool center) {
+    const size_t padded = numSamples + (center ? 2 * static_cast<size_t>(nFft / 2) : 0);
+    if (padded < static_cast<size_t>(nFft)) {
+        return 0;
+    }
+    return (padded - nFft) / std::max(1, hop) + 1;
+}
+
+void StftEngine::compute(const float* audio, size_t numSamples, SpectrumType type, float* out, size_t frames) {
+    const size_t bins = numBins();
+    for (size_t t = 0; t < frames; ++t) {
+        computeFrame(audio, numSamples, t, type, out + t * bins);
+    }
+}
+
+void StftEngine::computeFrame(const float* audio, size_t numSamples, size_t t, SpectrumType type, float* out) {
+    const size_t bins = numBins();
+    const long long n = static_cast<long long>(numSamples);
+    float* frame = m_frame.data();
+    const float* window = m_window.data();
+
+    // 가상 패딩 기준 프레임 시작 위치 (패딩 영역은 0)
+    const long long start = static_cast<long long>(t) * m_hop - m_pad;
+
+    if (start >= 0 && start + m_nFft <= n) {
+        // 대부분의 프레임: 신호 내부 - 복사 없이 윈도우 곱만 수행
+        const float* src = audio + start;
+        for (int i = 0; i < m_nFft; ++i) {
+            frame[i] = src[i] * window[i];
+        }
+    } else {
+        // 앞/뒤 가장자리 프레임: 범위 밖 샘플은 0
+        const long long from = std::max(0LL, -start);
+        const long long to = std::min(static_cast<long long>(m_nFft), n - start);
+        std::fill(frame, frame + m_nFft, 0.0f);
+        for (long long i = from; i < to; ++i) {
+            frame[i] = audio[start + i] * window[i];
+        }
+    }
+
+    m_fft.fwd(m_spectrum.data(), frame, m_nFft);
+
+    const std::complex<float>* spec = m_spectrum.data();
+    if (type == SpectrumType::Power) {
+        for (size_t k = 0; k < bins; ++k) {
+            out[k] = spec[k].real() * spec[k].real() + spec[k].imag() * spec[k].imag();
+        }
+    } else {
+        for (size_t k = 0; k < bins; ++k) {
+            out[k] = std::sqrt(spec[k].real() * spec[k].real() + spec[k].imag() * spec[k].imag());
+        }
+    }
+}
@@ -0,0 +1,67 @@
+//
+// Created by glion on 2025-12-08.
+// 할당 없는(allocation-free) STFT 커널 선언
+// FrameCutter -> Windowing -> PowerSpectrum/FFT 로 이어지는 프레임별 Essentia 알고리즘 호출을 하나의 루프로 대체
+//
+
+#ifndef NDK_ESSENTIA_TEST_STFT_ENGINE_H
+#define NDK_ESSENTIA_TEST_STFT_ENGINE_H
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+#include <unsupported/Eigen/FFT>
+
+namespace NdkEssentiaEmbedding {
+
+    enum class SpectrumType {
+        Power,     // |X|^2 (Essentia PowerSpectrum)
+        Magnitude  // |X|   (Essentia Spectrum)
+    };
+
+    class StftEngine {
+    public:
+        // nFft: 프레임/FFT 크기, hop: 프레임 간격, center: Librosa 'center=True' (앞뒤 nFft/2 가상 제로 패딩)
+        StftEngine(int nFft, int hop, bool center);
+
+        // 호출 스레드 전용 엔진 (윈도우 / FFT 플랜 / 임시 버퍼를 같은 설정끼리 재사용)
+        static StftEngine& threadLocal(int nFft, int hop, bool center);
+
+        // 프레임 수 (Essentia FrameCutter startFromZero, lastFrameToEndOfFile=false 와 동일: 완전한 프레임만)
+        static size_t frameCount(size_t numSamples, int nFft, int hop, bool center);
+        size_t numFrames(size_t numSamples) const { return frameCount(numSamples, m_nFft, m_hop, m_pad > 0); }
+        size_t numBins() const { return static_cast<size_t>(m_nFft / 2 + 1); }
+
+        /**
+         * @brief 패딩되지 않은 신호에서 프레임을 직접 읽어 스펙트럼 계산.
+         * @param out [frames][numBins] 연속 버퍼 (frames * numBins 이상)
+         * @param frames 계산할 프레임 수 (numFrames(numSamples) 이하)
+         */
+        void compute(const float* audio, size_t numSamples, SpectrumType type, float* out, size_t frames);
+
+        void compute(const float* audio, size_t numSamples, SpectrumType type, float* out) {
+            compute(audio, numSamples, type, out, numFrames(numSamples));
+        }
+
+        // 프레임 t 하나의 스펙트럼만 계산 (out: numBins 개)
+        void computeFrame(const float* audio, size_t numSamples, size_t t, SpectrumType type, float* out);
+
+    private:
+        int m_nFft;
+        int m_hop;
+        int m_pad;
+
+        // Essentia Windowing(type=hann, normalized=true) 와 동일한 윈도우
+        std::vector<float> m_window;
+
+        // FFT 플랜은 Eigen::FFT(kissfft) 내부에 크기별로 캐시됨
+        Eigen::FFT<float> m_fft;
+
+        // 임시 버퍼 (프레임마다 재할당하지 않음)
+        std::vector<float> m_frame;
+        std::vector<std::complex<float>> m_spectrum;
+    };
+}
+
+#endif //NDK_ESSENTIA_TEST_STFT_ENGINE_H
@@ -21,7 +21,7 @@ using namespace essentia::standard;
  * @param y_p 타악기(Percussive) 신호 출력
  */
 void EmbeddingHelper::performHPSS(
-        const std::vector<float>& audio,
+        AudioView audio,
         std::vector<float>& y_h,
         std::vector<float>& y_p
 ) {
@@ -45,7 +45,7 @@ void EmbeddingHelper::performHPSS(
 
     } catch (const EssentiaException& e) {
         // 오류 발생 시 원본 신호를 H와 P로 반환 (Python의 except 블록 처리)
-        y_h = audio;
-        y_p = audio;
+        y_h.assign(audio.begin(), audio.end());
+        y_p.assign(audio.begin(), audio.end());
     }
 }
\ No newline at end of file
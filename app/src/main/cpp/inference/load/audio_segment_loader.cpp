@@ -0,0 +1,160 @@
+//
+// Created by glion on 2025-12-03.
+// 세그먼트 단위 디코딩 - 컨테이너 길이로 세그먼트 위치를 먼저 계산하고 해당 구간만 seek 하여 디코딩
+//
+
+#include "embedding_helper.h"
+#include "load/ffmpeg_decoder.h"
+#include "cache/pcm_cache.h"
+#include "common/hash_util.h"
+#include <algorithm>
+
+using namespace NdkEssentiaEmbedding;
+
+// 이 간격(초)보다 가까운 세그먼트들은 seek 없이 하나의 구간으로 이어서 디코딩
+static constexpr float MERGE_GAP_SECONDS = 1.0f;
+
+/**
+ * @brief 세그먼트 위치를 계획하고 해당 구간만 디코딩.
+ * @return 전체 디코딩 + segmenter 와 동일한 결과를 보장할 수 있을 때만 true
+ */
+static bool decodePlannedSegments(
+        FfmpegDecoder& decoder,
+        const EmbeddingConfig& config,
+        SegmentedAudio& segments
+) {
+    int64_t estimatedTotal = 0, tolerance = 0;
+    if (!decoder.estimateTotalSamples(estimatedTotal, tolerance)) {
+        return false;
+    }
+
+    const float sampleRate = static_cast<float>(decoder.outSampleRate());
+    const int segmentLengthSamples = static_cast<int>(config.seg_seconds * sampleRate);
+    if (segmentLengthSamples <= 0) {
+        return false;
+    }
+
+    // 세그먼트보다 짧을 수 있는 곡은 마지막 세그먼트 길이가 정확한 총 길이에 의존하므로 전체 디코딩
+    if (estimatedTotal - tolerance < segmentLengthSamples) {
+        return false;
+    }
+
+    // 길이 추정 오차 범위의 양 끝에서 계획이 같아야 실제 길이에서도 같은 계획임 (starts 개수는 길이에 단조)
+    std::vector<int> starts = EmbeddingHelper::computeSegmentStarts(
+            static_cast<int>(estimatedTotal - tolerance), sampleRate, config);
+    std::vector<int> startsUpper = EmbeddingHelper::computeSegmentStarts(
+            static_cast<int>(estimatedTotal + tolerance), sampleRate, config);
+    if (starts.empty() || starts != startsUpper) {
+        LOGD("Segment plan is not stable within duration tolerance");
+        return false;
+    }
+
+    segments.buffers.clear();
+    segments.segments.assign(starts.size(), AudioView());
+    const int64_t mergeGap = static_cast<int64_t>(MERGE_GAP_SECONDS * sampleRate);
+
+    // 겹치거나 가까운 세그먼트는 하나의 구간으로 묶어서 1회만 디코딩
+    size_t first = 0;
+    while (first < starts.size()) {
+        size_t last = first;
+        int64_t rangeEnd = static_cast<int64_t>(starts[first]) + segmentLengthSamples;
+        while (last + 1 < starts.size() && starts[last + 1] <= rangeEnd + mergeGap) {
+            ++last;
+            rangeEnd = static_cast<int64_t>(starts[last]) + segmentLengthSamples;
+        }
+        const int64_t rangeStart = starts[first];
+
+        // 구간 1개를 버퍼 1개로 디코딩하고, 구간에 속한 세그먼트는 그 안을 가리키는 뷰로 생성 (복사 없음)
+        std::vector<float> range;
+        if (!decoder.decodeRange(rangeStart, rangeEnd - rangeStart, range)) {
+            return false;
+        }
+        segments.buffers.push_back(std::move(range));
+
+        const AudioView rangeView(segments.buffers.back());
+        for (size_t i = first; i <= last; ++i) {
+            segments.segments[i] = rangeView.subView(starts[i] - rangeStart, segmentLengthSamples);
+        }
+        first = last + 1;
+    }
+
+    // 지각 지문은 타임라인 0 부터의 구간이 필요하므로 첫 세그먼트가 0 에서 시작할 때만 (전체 디코딩과 같은 샘플)
+    if (starts.front() == 0) {
+        const std::vector<float>& head = segments.buffers.front();
+        segments.fingerprint.perceptual = perceptualFingerprint(head.data(), head.size(), 1);
+    }
+    return true;
+}
+
+/**
+ * @brief 캐시된 PCM 에서 세그먼트 구간만 float32 로 변환 (전체 디코딩 + segmenter 와 같은 세그먼트)
+ */
+static SegmentedAudio segmentsFromPcmCache(const PcmCache::Entry& pcm, const EmbeddingConfig& config) {
+    const int totalSamples = static_cast<int>(pcm.size());
+    const float sampleRate = static_cast<float>(pcm.sampleRate());
+    const std::vector<int> starts = EmbeddingHelper::computeSegmentStarts(totalSamples, sampleRate, config);
+    const int segmentLengthSamples = static_cast<int>(config.seg_seconds * sampleRate);
+
+    SegmentedAudio segments;
+    for (int start : starts) {
+        const int end = std::min(start + segmentLengthSamples, totalSamples);
+        std::vector<float> buffer(static_cast<size_t>(end - start));
+        pcm.toFloat(static_cast<size_t>(start), buffer.size(), buffer.data());
+        segments.buffers.push_back(std::move(buffer));
+        segments.segments.emplace_back(segments.buffers.back());
+    }
+    segments.fingerprint = pcm.fingerprint();
+    return segments;
+}
+
+bool EmbeddingHelper::loadPlannedSegments(
+        const AudioSource& source,
+        const EmbeddingConfig& config,
+        SegmentedAudio& out
+) {
+    // 구간 디코딩은 모노 출력에서만 사용 (segmenter 는 샘플 = 프레임 가정)
+    if (!config.isMono) {
+        return false;
+    }
+    FfmpegDecoder decoder;
+    SegmentedAudio segments;
+    if (!decoder.open(source, config) || !decodePlannedSegments(decoder, config, segments)) {
+        return false;
+    }
+    // 지문: 첫 seek 전에 EOF 까지 디먹스한 전체 패킷 해시 (지각 지문은 decodePlannedSegments 에서 계산)
+    segments.fingerprint.packets = decoder.packetHash();
+    out = std::move(segments);
+    return true;
+}
+
+SegmentedAudio EmbeddingHelper::loadAudioSegments(
+        const AudioSource& source,
+        const EmbeddingConfig& config
+) {
+    // 시간 측정
+    RunTimerLogger timer("loadAudioSegments Function");
+
+    if (m_pcm_cache) {
+        // PCM 캐시 적중 시 세그먼트 구간만 변환 (모노만 - segmenter 는 샘플 = 프레임 가정)
+        PcmCache::Entry cached;
+        if (config.isMono && m_pcm_cache->load(source, config.sr, config.isMono, cached)) {
+            LOGD("PCM cache hit : %s", source.describe().c_str());
+            return segmentsFromPcmCache(cached, config);
+        }
+        // 미적중 시 구간 디코딩 대신 전체 디코딩하여 캐시 (이후 세그먼트 / 특징 설정이 바뀌어도 재사용)
+    } else if (config.segment_only_decode && config.isMono) {
+        SegmentedAudio segments;
+        if (loadPlannedSegments(source, config, segments)) {
+            return segments;
+        }
+        LOGW("Segment-only decoding unavailable, fallback to full decode : %s", source.describe().c_str());
+    }
+
+    // 전체 디코딩 후 세그먼트 분할 (디코딩 버퍼를 그대로 넘겨받고 세그먼트는 뷰로 생성)
+    AudioData audioResults = loadAudioFile(source, config);
+    SegmentedAudio segments;
+    segments.segments = segmenter(audioResults, config);
+    segments.fingerprint = audioResults.fingerprint;
+    segments.buffers.push_back(std::move(audioResults.samples));
+    return segments;
+}
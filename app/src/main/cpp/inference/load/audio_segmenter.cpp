@@ -8,20 +8,17 @@
 #include <algorithm> // std::min 사용
 
 using namespace NdkEssentiaEmbedding;
-std::vector<std::vector<float>> EmbeddingHelper::segmenter(
-        const AudioData &audioData,
+
+std::vector<int> EmbeddingHelper::computeSegmentStarts(
+        int totalSamples,
+        float sampleRate,
         const EmbeddingConfig &config
 ) {
-    // 시간 측정
-    RunTimerLogger timer("segmenter Function");
-
     // 1. 샘플 단위로 변환 (Python 'int()'와 동일하게 절삭)
-    const int segmentLengthSamples = static_cast<int>(config.seg_seconds * audioData.sampleRate);
+    const int segmentLengthSamples = static_cast<int>(config.seg_seconds * sampleRate);
 
     // [수정 3] Python의 max(1, ...) 적용
-    const int hopLengthSamples = std::max(1, static_cast<int>(config.hop_seconds * audioData.sampleRate));
-
-    const int totalSamples = audioData.samples.size();
+    const int hopLengthSamples = std::max(1, static_cast<int>(config.hop_seconds * sampleRate));
 
     // Python: 'if not starts:'와 'if segmentLengthSamples <= 0'을 함께 처리
     if (segmentLengthSamples <= 0 || totalSamples == 0) {
@@ -56,20 +53,34 @@ std::vector<std::vector<float>> EmbeddingHelper::segmenter(
         starts = std::move(sampled_starts); // 샘플링된 리스트로 교체
     }
 
-    // 4. (3)에서 확정된 'starts' 리스트를 기반으로 실제 세그먼트 생성
-    std::vector<std::vector<float>> segments;
+    return starts;
+}
+
+std::vector<AudioView> EmbeddingHelper::segmenter(
+        const AudioData &audioData,
+        const EmbeddingConfig &config
+) {
+    // 시간 측정
+    RunTimerLogger timer("segmenter Function");
+
+    const int totalSamples = audioData.samples.size();
+
+    // 1~3. 세그먼트 시작 위치 계산 (구간 디코딩과 동일한 로직 공유)
+    std::vector<int> starts = computeSegmentStarts(totalSamples, audioData.sampleRate, config);
+    const int segmentLengthSamples = static_cast<int>(config.seg_seconds * audioData.sampleRate);
+
+    // 4. (3)에서 확정된 'starts' 리스트를 기반으로 세그먼트 뷰 생성 (샘플 복사 없음)
+    std::vector<AudioView> segments;
     segments.reserve(starts.size()); // 메모리 미리 할당
 
+    const AudioView whole(audioData.samples);
     for (int start : starts) {
         // [수정 1] Python의 y[s:e] 슬라이스는 'end'가 길이를 초과해도 알아서 잘라줌
         // C++의 std::min이 그 역할을 정확히 수행함.
         const int end = std::min(start + segmentLengthSamples, totalSamples);
 
-        auto start_it = audioData.samples.begin() + start;
-        auto end_it = audioData.samples.begin() + end;
-
         // Python의 'y[s:e]' 슬라이싱
-        segments.emplace_back(start_it, end_it);
+        segments.push_back(whole.subView(start, end - start));
     }
 
     return segments;
@@ -0,0 +1,456 @@
+//
+// Created by glion on 2025-12-03.
+// FfmpegDecoder 구현 - ffmpeg 사용하여 float32 PCM 형태로 리샘플링 및 모노 변환
+//
+
+#include "load/ffmpeg_decoder.h"
+#include "common/log_util.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+
+// FFmpeg 헤더 (구현 파일에서만 필요)
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+#include <libswresample/swresample.h>
+#include <libavutil/opt.h>
+#include <libavutil/channel_layout.h>
+#include <libavutil/common.h>
+#include <libavutil/mathematics.h>
+#include <libavutil/samplefmt.h>
+}
+
+using namespace NdkEssentiaEmbedding;
+
+// swr_convert 1회 출력 버퍼 크기 (샘플)
+static constexpr int MAX_OUT_SAMPLES = 4096;
+
+// 사용자 정의 AVIOContext 읽기 버퍼 크기 (바이트)
+static constexpr int IO_BUFFER_SIZE = 64 * 1024;
+
+FfmpegDecoder::~FfmpegDecoder() {
+    if (m_convertedData) {
+        av_freep(&m_convertedData[0]);
+        av_freep(&m_convertedData);
+    }
+    av_frame_free(&m_frame);
+    av_packet_free(&m_packet);
+    swr_free(&m_swrCtx);
+    avcodec_free_context(&m_codecCtx);
+    avformat_close_input(&m_formatCtx);
+    // 사용자 정의 입력은 avformat_close_input 이 해제하지 않음 (버퍼는 FFmpeg 가 교체했을 수 있으므로 컨텍스트의 것을 해제)
+    if (m_ioCtx) {
+        av_freep(&m_ioCtx->buffer);
+        avio_context_free(&m_ioCtx);
+    }
+}
+
+int FfmpegDecoder::readSource(void* opaque, uint8_t* buf, int bufSize) {
+    auto* self = static_cast<FfmpegDecoder*>(opaque);
+    const int64_t read = self->m_source.readAt(self->m_ioPos, buf, static_cast<size_t>(bufSize));
+    if (read < 0) {
+        return AVERROR(EIO);
+    }
+    if (read == 0) {
+        return AVERROR_EOF;
+    }
+    self->m_ioPos += read;
+    return static_cast<int>(read);
+}
+
+int64_t FfmpegDecoder::seekSource(void* opaque, int64_t offset, int whence) {
+    auto* self = static_cast<FfmpegDecoder*>(opaque);
+    const int64_t size = self->m_source.size();
+    if (whence & AVSEEK_SIZE) {
+        return size;
+    }
+    int64_t position;
+    switch (whence & ~AVSEEK_FORCE) {
+        case SEEK_SET: position = offset; break;
+        case SEEK_CUR: position = self->m_ioPos + offset; break;
+        case SEEK_END: position = size + offset; break;
+        default: return AVERROR(EINVAL);
+    }
+    if (position < 0) {
+        return AVERROR(EINVAL);
+    }
+    self->m_ioPos = position;
+    return position;
+}
+
+bool FfmpegDecoder::openCustomIo() {
+    m_formatCtx = avformat_alloc_context();
+    auto* buffer = static_cast<uint8_t*>(av_malloc(IO_BUFFER_SIZE));
+    if (!m_formatCtx || !buffer) {
+        av_free(buffer);
+        return false;
+    }
+    m_ioPos = 0;
+    m_ioCtx = avio_alloc_context(buffer, IO_BUFFER_SIZE, 0, this, &FfmpegDecoder::readSource, nullptr,
+                                 &FfmpegDecoder::seekSource);
+    if (!m_ioCtx) {
+        av_free(buffer);
+        return false;
+    }
+    m_formatCtx->pb = m_ioCtx;
+    m_formatCtx->flags |= AVFMT_FLAG_CUSTOM_IO;
+    return true;
+}
+
+bool FfmpegDecoder::open(const AudioSource& source, const EmbeddingConfig& config) {
+    // ------------------ (1) 초기화 및 스트림 찾기 ------------------
+    // fd / 메모리 입력은 사용자 정의 AVIOContext 로 그 자리에서 읽음 (임시 파일 없음)
+    m_source = source;
+    if (!source.isPath() && !openCustomIo()) {
+        LOGE("Failed to create custom AVIOContext : %s", source.describe().c_str());
+        return false;
+    }
+    const char* url = source.isPath() ? source.path().c_str() : "";
+    if (avformat_open_input(&m_formatCtx, url, nullptr, nullptr) < 0) {
+        LOGE("Failed to open input file : %s", source.describe().c_str());
+        return false;
+    }
+
+    if (avformat_find_stream_info(m_formatCtx, nullptr) < 0) {
+        LOGE("Failed to retrieve stream info");
+        return false;
+    }
+
+    m_streamIndex = av_find_best_stream(m_formatCtx, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0);
+    if (m_streamIndex < 0) {
+        LOGE("Failed to find audio stream");
+        return false;
+    }
+
+    AVStream *audioStream = m_formatCtx->streams[m_streamIndex];
+    const AVCodec *codec = avcodec_find_decoder(audioStream->codecpar->codec_id);
+    if (!codec) {
+        LOGE("Failed to find decoder");
+        return false;
+    }
+
+    m_codecCtx = avcodec_alloc_context3(codec);
+    if (!m_codecCtx) {
+        LOGE("Failed to allocate codec context");
+        return false;
+    }
+
+    if (avcodec_parameters_to_context(m_codecCtx, audioStream->codecpar) < 0) {
+        LOGE("Failed to copy codec parameters");
+        return false;
+    }
+
+    // 디코더 스레드 (프레임 / 슬라이스 스레딩을 지원하는 코덱에서만 사용됨)
+    m_codecCtx->thread_count = std::max(1, config.decoder_threads);
+    m_codecCtx->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+
+    if (avcodec_open2(m_codecCtx, codec, nullptr) < 0) {
+        LOGE("Failed to open codec");
+        return false;
+    }
+
+    // ✅ 리샘플링 컨텍스트 설정
+    m_swrCtx = swr_alloc();
+    AVChannelLayout out_ch_layout;
+    if (config.isMono) {
+        av_channel_layout_default(&out_ch_layout, 1);
+    } else {
+        av_channel_layout_copy(&out_ch_layout, &m_codecCtx->ch_layout);
+    }
+    m_outChannels = out_ch_layout.nb_channels;
+
+    AVSampleFormat out_sample_fmt = AV_SAMPLE_FMT_FLT;  // float32
+    m_outSampleRate = static_cast<int>(config.sr);
+
+    av_opt_set_chlayout(m_swrCtx, "in_chlayout", &m_codecCtx->ch_layout, 0);
+    av_opt_set_int(m_swrCtx, "in_sample_rate", m_codecCtx->sample_rate, 0);
+    av_opt_set_sample_fmt(m_swrCtx, "in_sample_fmt", m_codecCtx->sample_fmt, 0);
+
+    av_opt_set_chlayout(m_swrCtx, "out_chlayout", &out_ch_layout, 0);
+    av_opt_set_int(m_swrCtx, "out_sample_rate", m_outSampleRate, 0);
+    av_opt_set_sample_fmt(m_swrCtx, "out_sample_fmt", out_sample_fmt, 0);
+
+    // 채널 레이아웃 해제 (swr 에 복사되었으므로 더 이상 필요 없음)
+    av_channel_layout_uninit(&out_ch_layout);
+
+    if (swr_init(m_swrCtx) < 0) {
+        LOGE("Failed to initialize resampler");
+        return false;
+    }
+
+    // 지문: 같은 압축 스트림이라도 코덱 설정이 다르면 구분
+    // (컨테이너 길이는 비트레이트 추정 시 뒤쪽 태그 크기에 따라 달라지므로 포함하지 않음)
+    const AVCodecParameters* par = audioStream->codecpar;
+    const int64_t streamInfo[] = {
+            static_cast<int64_t>(par->codec_id), par->sample_rate, par->ch_layout.nb_channels
+    };
+    m_packetHasher.update(streamInfo, sizeof(streamInfo));
+    if (par->extradata != nullptr && par->extradata_size > 0) {
+        m_packetHasher.update(par->extradata, static_cast<size_t>(par->extradata_size));
+    }
+
+    m_packet = av_packet_alloc();
+    m_frame = av_frame_alloc();
+    av_samples_alloc_array_and_samples(
+            &m_convertedData, nullptr,
+            m_outChannels, MAX_OUT_SAMPLES,
+            out_sample_fmt, 0);
+
+    return m_packet && m_frame && m_convertedData;
+}
+
+int FfmpegDecoder::readPacket() {
+    const int ret = av_read_frame(m_formatCtx, m_packet);
+    if (m_fingerprintDone) {
+        return ret;
+    }
+    if (ret < 0) {
+        // EOF 면 스트림 전체 패킷을 누적한 것 (읽기 오류면 일부만 누적되었으므로 지문 없음)
+        m_fingerprintDone = true;
+        m_fingerprintComplete = ret == AVERROR_EOF;
+    } else if (m_packet->stream_index == m_streamIndex && m_packet->data != nullptr) {
+        m_packetHasher.update(m_packet->data, static_cast<size_t>(m_packet->size));
+        ++m_hashedPackets;
+        m_hashedBytes += m_packet->size;
+    }
+    return ret;
+}
+
+void FfmpegDecoder::completeFingerprint() {
+    // 디먹스만 수행 (디코딩 없음) - 전체 디코딩과 같은 패킷 집합
+    while (!m_fingerprintDone && readPacket() >= 0) {
+        av_packet_unref(m_packet);
+    }
+    m_fingerprintDone = true;
+}
+
+uint64_t FfmpegDecoder::packetHash() const {
+    if (!m_fingerprintComplete) {
+        return 0;
+    }
+    // 앞부분 패킷이 우연히 같은 다른 길이의 스트림과 구분되도록 패킷 수 / 바이트 수도 포함
+    Fnv1aHasher hasher = m_packetHasher;
+    hasher.update(&m_hashedPackets, sizeof(m_hashedPackets));
+    hasher.update(&m_hashedBytes, sizeof(m_hashedBytes));
+    return hasher.value();
+}
+
+bool FfmpegDecoder::estimateTotalSamples(int64_t& totalSamples, int64_t& tolerance) const {
+    if (!m_formatCtx || m_streamIndex < 0) {
+        return false;
+    }
+    // 비트레이트로 추정한 길이(헤더 없는 VBR MP3 등)는 오차가 커서 사용하지 않음
+    if (m_formatCtx->duration_estimation_method == AVFMT_DURATION_FROM_BITRATE) {
+        return false;
+    }
+
+    const AVStream *stream = m_formatCtx->streams[m_streamIndex];
+    const AVRational outTimeBase{1, m_outSampleRate};
+    if (stream->duration != AV_NOPTS_VALUE && stream->duration > 0) {
+        totalSamples = av_rescale_q(stream->duration, stream->time_base, outTimeBase);
+    } else if (m_formatCtx->duration != AV_NOPTS_VALUE && m_formatCtx->duration > 0) {
+        totalSamples = av_rescale_q(m_formatCtx->duration, AVRational{1, AV_TIME_BASE}, outTimeBase);
+    } else {
+        return false;
+    }
+
+    // 인코더 delay/padding 및 컨테이너 반올림 오차를 넉넉히 덮는 0.5초
+    tolerance = m_outSampleRate / 2;
+    return totalSamples > 0;
+}
+
+void FfmpegDecoder::convertFrame(
+        const uint8_t** data, int nbSamples,
+        int64_t rangeStart, int64_t rangeEnd, std::vector<float>& out) {
+    // [핵심] 프레임을 리샘플러로 보냄 (data == nullptr 이면 리샘플러 flush)
+    int converted = swr_convert(m_swrCtx, m_convertedData, MAX_OUT_SAMPLES, data, nbSamples);
+    if (converted <= 0) {
+        return;
+    }
+
+    // 출력 타임라인 위치 기준으로 요청 구간에 걸친 부분만 추가
+    const int64_t from = std::max(m_outPos, rangeStart);
+    const int64_t to = std::min(m_outPos + converted, rangeEnd);
+    if (from < to) {
+        const float *samples = reinterpret_cast<float *>(m_convertedData[0]);
+        out.insert(out.end(),
+                   samples + (from - m_outPos) * m_outChannels,
+                   samples + (to - m_outPos) * m_outChannels);
+    }
+    m_outPos += converted;
+}
+
+void FfmpegDecoder::flush(int64_t rangeStart, int64_t rangeEnd, std::vector<float>& out) {
+    // 파일이 끝났으므로 디코더에 NULL 패킷 전송
+    if (avcodec_send_packet(m_codecCtx, nullptr) >= 0) {
+        while (avcodec_receive_frame(m_codecCtx, m_frame) >= 0) {
+            // 마지막 남은 프레임 리샘플링
+            convertFrame((const uint8_t **) m_frame->data, m_frame->nb_samples, rangeStart, rangeEnd, out);
+        }
+    }
+
+    // 디코더가 끝났으므로 리샘플러에 NULL 입력 전송 (입력 샘플 수 = 0)
+    int64_t before;
+    do {
+        before = m_outPos;
+        convertFrame(nullptr, 0, rangeStart, rangeEnd, out);
+    } while (m_outPos > before); // 리샘플러가 0을 반환할 때까지 반복
+}
+
+void FfmpegDecoder::decodeAll(std::vector<float>& out) {
+    const int64_t rangeEnd = std::numeric_limits<int64_t>::max();
+    m_outPos = 0;
+
+    // --- 메인 디코딩 루프 ---
+    while (readPacket() >= 0) {
+        if (m_packet->stream_index == m_streamIndex) {
+            if (avcodec_send_packet(m_codecCtx, m_packet) >= 0) {
+                while (avcodec_receive_frame(m_codecCtx, m_frame) >= 0) {
+                    convertFrame((const uint8_t **) m_frame->data, m_frame->nb_samples, 0, rangeEnd, out);
+                }
+            }
+        }
+        av_packet_unref(m_packet);
+    }
+
+    flush(0, rangeEnd, out);
+}
+
+bool FfmpegDecoder::probeFirstPts() {
+    // 전체 디코딩 시 첫 출력 샘플이 되는 프레임의 pts 를 1회 조회 (이후 구간 디코딩은 항상 seek 하므로 상태 무관)
+    while (readPacket() >= 0) {
+        if (m_packet->stream_index == m_streamIndex && avcodec_send_packet(m_codecCtx, m_packet) >= 0) {
+            if (avcodec_receive_frame(m_codecCtx, m_frame) >= 0) {
+                av_packet_unref(m_packet);
+                if (m_frame->best_effort_timestamp == AV_NOPTS_VALUE) {
+                    return false;
+                }
+                m_firstPts = m_frame->best_effort_timestamp;
+                m_firstPtsKnown = true;
+                return true;
+            }
+        }
+        av_packet_unref(m_packet);
+    }
+    return false;
+}
+
+bool FfmpegDecoder::resetResampler() {
+    // 이전 구간의 필터 상태/지연 샘플 제거 (설정값은 유지됨)
+    swr_close(m_swrCtx);
+    return swr_init(m_swrCtx) >= 0;
+}
+
+bool FfmpegDecoder::decodeRange(int64_t startSample, int64_t numSamples, std::vector<float>& out) {
+    if (numSamples <= 0 || !m_formatCtx) {
+        return false;
+    }
+    if (!m_firstPtsKnown && !probeFirstPts()) {
+        LOGW("Failed to probe first pts");
+        return false;
+    }
+
+    const AVStream *stream = m_formatCtx->streams[m_streamIndex];
+    const int inRate = m_codecCtx->sample_rate;
+    const AVRational inTimeBase{1, inRate};
+    const int64_t endSample = startSample + numSamples;
+
+    // 출력 startSample 에 해당하는 입력 샘플 위치
+    const int64_t startIn = av_rescale(startSample, inRate, m_outSampleRate);
+    // 디코더 pre-roll: seek_preroll + 0.25초 (MP3 bit reservoir / MDCT overlap / 리샘플러 필터 워밍업)
+    const int64_t prerollIn = std::max<int64_t>(0, stream->codecpar->seek_preroll) + inRate / 4;
+    // seek 위치가 이보다 가까우면 디코더 상태가 전체 디코딩과 다를 수 있음
+    const int64_t minWarmupIn = inRate / 20;
+    const int64_t seekIn = std::max<int64_t>(0, startIn - prerollIn);
+
+    const int64_t seekTs = m_firstPts + av_rescale_q(seekIn, inTimeBase, stream->time_base);
+    // seek 이후에는 순차 읽기가 아니므로 그 전에 남은 패킷을 EOF 까지 디먹스하여 지문 완료 (첫 구간에서만 수행)
+    completeFingerprint();
+    if (av_seek_frame(m_formatCtx, m_streamIndex, seekTs, AVSEEK_FLAG_BACKWARD) < 0) {
+        LOGW("av_seek_frame failed (ts = %lld)", (long long) seekTs);
+        return false;
+    }
+    avcodec_flush_buffers(m_codecCtx);
+    if (!resetResampler()) {
+        return false;
+    }
+
+    // 리샘플러 위상 주기(입력 샘플): 이 배수 위치에서 시작해야 전체 디코딩과 같은 출력 샘플 격자에 놓임
+    const int64_t phaseIn = inRate / av_gcd(inRate, m_outSampleRate);
+    const int bytesPerSample = av_get_bytes_per_sample(m_codecCtx->sample_fmt);
+    const bool planar = av_sample_fmt_is_planar(m_codecCtx->sample_fmt) != 0;
+    const int inChannels = m_codecCtx->ch_layout.nb_channels;
+
+    out.clear();
+    out.reserve(static_cast<size_t>(numSamples * m_outChannels));
+
+    bool seenFrame = false;
+    bool started = false;
+    int64_t expectedIn = 0; // 다음 프레임의 예상 입력 샘플 위치 (타임스탬프 연속성 검사용)
+    std::vector<const uint8_t *> planePtrs;
+
+    // 디코딩된 프레임 1개 처리. 전체 디코딩과 동일성을 보장할 수 없으면 false
+    auto handleFrame = [&]() -> bool {
+        const int64_t pts = m_frame->best_effort_timestamp;
+        if (pts == AV_NOPTS_VALUE) {
+            return false;
+        }
+        const int64_t frameIn = av_rescale_q(pts - m_firstPts, stream->time_base, inTimeBase);
+        const int nbSamples = m_frame->nb_samples;
+
+        if (!seenFrame) {
+            // seek 가 목표보다 뒤에 떨어졌거나 워밍업이 부족하면 실패 (스트림 시작은 전체 디코딩과 동일 상태)
+            if (frameIn > 0 && frameIn + minWarmupIn > startIn) {
+                return false;
+            }
+            seenFrame = true;
+        } else if (std::abs(frameIn - expectedIn) > inRate / 1000) {
+            // 1ms 이상 타임스탬프 불연속
+            return false;
+        }
+        expectedIn = frameIn + nbSamples;
+
+        int skip = 0;
+        if (!started) {
+            // 타임라인 0 이전 샘플 및 위상 정렬을 위한 앞부분 샘플은 건너뜀
+            int64_t alignedIn = frameIn <= 0 ? 0 : ((frameIn + phaseIn - 1) / phaseIn) * phaseIn;
+            if (alignedIn - frameIn >= nbSamples) {
+                return true; // 프레임 전체가 정렬 지점 이전
+            }
+            skip = static_cast<int>(alignedIn - frameIn);
+            m_outPos = av_rescale(alignedIn, m_outSampleRate, inRate);
+            started = true;
+        }
+
+        // 건너뛸 샘플만큼 각 plane 포인터 이동 (packed 포맷은 plane 1개에 채널 인터리브)
+        const int planes = planar ? inChannels : 1;
+        const int64_t offset = static_cast<int64_t>(skip) * bytesPerSample * (planar ? 1 : inChannels);
+        planePtrs.resize(planes);
+        for (int p = 0; p < planes; ++p) {
+            planePtrs[p] = m_frame->extended_data[p] + offset;
+        }
+        convertFrame(planePtrs.data(), nbSamples - skip, startSample, endSample, out);
+        return true;
+    };
+
+    const size_t wanted = static_cast<size_t>(numSamples * m_outChannels);
+    bool ok = true;
+    while (ok && out.size() < wanted) {
+        if (readPacket() < 0) {
+            // EOF: 남은 샘플 flush
+            flush(startSample, endSample, out);
+            break;
+        }
+        if (m_packet->stream_index == m_streamIndex && avcodec_send_packet(m_codecCtx, m_packet) >= 0) {
+            while (ok && out.size() < wanted && avcodec_receive_frame(m_codecCtx, m_frame) >= 0) {
+                ok = handleFrame();
+            }
+        }
+        av_packet_unref(m_packet);
+    }
+
+    return ok && out.size() == wanted;
+}
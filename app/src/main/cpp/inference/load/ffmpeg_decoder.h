@@ -0,0 +1,104 @@
+//
+// Created by glion on 2025-12-03.
+// FFmpeg 디먹스/디코딩/리샘플링 컨텍스트를 묶은 RAII 디코더
+// 전체 디코딩(loadAudioFile)과 구간 디코딩(loadAudioSegments)이 동일한 초기화/리샘플링 경로를 공유
+//
+
+#ifndef NDK_ESSENTIA_TEST_FFMPEG_DECODER_H
+#define NDK_ESSENTIA_TEST_FFMPEG_DECODER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "struct/embedding_config.h"
+#include "common/hash_util.h"
+#include "common/audio_source.h"
+
+// FFmpeg 타입은 전방 선언만 사용 (FFmpeg 헤더는 구현 파일에서만 필요)
+struct AVFormatContext;
+struct AVIOContext;
+struct AVCodecContext;
+struct SwrContext;
+struct AVPacket;
+struct AVFrame;
+
+namespace NdkEssentiaEmbedding {
+
+    class FfmpegDecoder {
+    public:
+        FfmpegDecoder() = default;
+        ~FfmpegDecoder();
+
+        FfmpegDecoder(const FfmpegDecoder&) = delete;
+        FfmpegDecoder& operator=(const FfmpegDecoder&) = delete;
+
+        // 입력 열기 + 디코더/리샘플러 초기화. 실패 시 LOGE 후 false
+        // fd / 메모리 입력은 pread / memcpy 기반 사용자 정의 AVIOContext 로 읽음 (source 는 디코더가 복사해 보관)
+        bool open(const AudioSource& source, const EmbeddingConfig& config);
+
+        int outSampleRate() const { return m_outSampleRate; }
+        int outChannels() const { return m_outChannels; }
+
+        // 컨테이너 길이로부터 추정한 출력 샘플 수와 허용 오차(샘플). 신뢰할 수 없으면 false
+        bool estimateTotalSamples(int64_t& totalSamples, int64_t& tolerance) const;
+
+        // 처음부터 끝까지 디코딩하여 out 뒤에 추가 (인터리브 float32)
+        void decodeAll(std::vector<float>& out);
+
+        // 전체 디코딩 기준 출력 샘플 [startSample, startSample + numSamples) 구간만 seek 하여 디코딩
+        // 전체 디코딩과 동일한 결과를 보장할 수 없는 경우(seek 실패, 타임스탬프 불연속, EOF 등) false
+        bool decodeRange(int64_t startSample, int64_t numSamples, std::vector<float>& out);
+
+        // 오디오 스트림 전체 압축 패킷 스트리밍 해시 + 코덱 파라미터 + 패킷 수 / 바이트 수
+        // decodeAll 은 디코딩하며 누적하고, decodeRange 는 첫 seek 전에 남은 패킷을 디코딩 없이 EOF 까지 읽어 채우므로 경로와 무관
+        // 스트림 끝까지 읽지 못했으면(읽기 오류 등) 0 - 앞부분만 같은 다른 파일(잘린 다운로드, 편집본 등)과 구분되지 않으므로
+        uint64_t packetHash() const;
+
+    private:
+        // av_read_frame + 첫 seek 전의 오디오 스트림 패킷이면 지문 해시에 누적 (EOF 에 도달하면 지문 완료)
+        int readPacket();
+        // 남은 패킷을 디코딩 없이 EOF 까지 읽어 지문 완료 (seek 전에 호출 - seek 이후에는 순차 읽기가 아님)
+        void completeFingerprint();
+        // fd / 메모리 입력용 AVIOContext 생성 및 m_formatCtx 에 연결
+        bool openCustomIo();
+        // AVIOContext 콜백 (opaque = this)
+        static int readSource(void* opaque, uint8_t* buf, int bufSize);
+        static int64_t seekSource(void* opaque, int64_t offset, int whence);
+        // 프레임 1개를 리샘플링하여 출력 타임라인(m_outPos) 기준 [rangeStart, rangeEnd) 만 out 에 추가
+        void convertFrame(const uint8_t** data, int nbSamples,
+                          int64_t rangeStart, int64_t rangeEnd, std::vector<float>& out);
+        // 디코더 / 리샘플러 잔여 샘플 flush
+        void flush(int64_t rangeStart, int64_t rangeEnd, std::vector<float>& out);
+        // 첫 디코딩 프레임의 pts (전체 디코딩 타임라인의 0번 샘플) 조회
+        bool probeFirstPts();
+        bool resetResampler();
+
+        AVFormatContext* m_formatCtx = nullptr;
+        AVIOContext* m_ioCtx = nullptr;      // 사용자 정의 입력 (경로 입력이면 nullptr)
+        AudioSource m_source{std::string()};
+        int64_t m_ioPos = 0;                 // 사용자 정의 입력의 현재 읽기 위치
+        AVCodecContext* m_codecCtx = nullptr;
+        SwrContext* m_swrCtx = nullptr;
+        AVPacket* m_packet = nullptr;
+        AVFrame* m_frame = nullptr;
+        uint8_t** m_convertedData = nullptr;
+
+        int m_streamIndex = -1;
+        int m_outSampleRate = 0;
+        int m_outChannels = 0;
+
+        // 전체 디코딩 타임라인 기준 현재 리샘플러 출력 위치 (출력 샘플 단위)
+        int64_t m_outPos = 0;
+        int64_t m_firstPts = 0;
+        bool m_firstPtsKnown = false;
+
+        Fnv1aHasher m_packetHasher;
+        int64_t m_hashedPackets = 0;
+        int64_t m_hashedBytes = 0;
+        bool m_fingerprintDone = false;     // EOF / 읽기 오류 / seek 이후 - 더 이상 누적하지 않음
+        bool m_fingerprintComplete = false; // 오디오 스트림 전체 패킷을 누적함
+    };
+}
+
+#endif //NDK_ESSENTIA_TEST_FFMPEG_DECODER_H
@@ -4,6 +4,7 @@
 //
 
 #include "embedding_helper.h"
+#include "onnx/inference_batch.h"
 #include <stdexcept>
 #include <memory>
 #include <algorithm> // std::copy 사용
@@ -23,30 +24,21 @@ std::vector<std::vector<float>> EmbeddingHelper::runInference(
         throw std::runtime_error("ONNX session is not initialized.");
     }
 
-    // 2. 입력 노드 이름 가져오기
+    // 2. 입력 노드 이름 확인
     // ONNX Runtime의 Run API는 입력 텐서와 함께 입력 노드의 "이름"을 필요로 합니다.
-    std::vector<std::string> input_node_names;
-    std::vector<const char*> input_names_char;
-    Ort::AllocatorWithDefaultOptions allocator;
-
-    size_t num_input_nodes = ort_session->GetInputCount();
+    // 이름은 initOrtSession() 에서 캐시해 두었으므로 매 호출마다 조회하지 않습니다.
+    size_t num_input_nodes = m_input_names_char.size();
     if (num_input_nodes != inputTensors.size()) {
         LOGE("Input tensor count mismatch. Model expects %zu, but %zu were provided.",
              num_input_nodes, inputTensors.size());
         throw std::runtime_error("Input tensor count mismatch.");
     }
 
-    input_node_names.reserve(num_input_nodes);
-    input_names_char.reserve(num_input_nodes);
-
-    for (size_t i = 0; i < num_input_nodes; i++) {
-        // 세션에서 직접 입력 노드 이름을 할당받아 사용
-        auto input_name_ptr = ort_session->GetInputNameAllocated(i, allocator);
-        input_node_names.push_back(input_name_ptr.get());
-        input_names_char.push_back(input_node_names.back().c_str());
-    }
-
     // 3. 출력 노드 이름 설정
+    if (std::find(m_output_names.begin(), m_output_names.end(), outputName) == m_output_names.end()) {
+        LOGE("Output node '%s' does not exist in the model.", outputName.c_str());
+        throw std::runtime_error("Unknown output node name: " + outputName);
+    }
     std::vector<const char*> output_names_char;
     output_names_char.push_back(outputName.c_str());
 
@@ -55,7 +47,7 @@ std::vector<std::vector<float>> EmbeddingHelper::runInference(
     try {
         output_tensors = ort_session->Run(
                 Ort::RunOptions{nullptr}, // 기본 실행 옵션
-                input_names_char.data(),  // 입력 노드 이름 배열
+                m_input_names_char.data(), // 입력 노드 이름 배열 (캐시)
                 inputTensors.data(),      // 입력 Ort::Value 배열
                 inputTensors.size(),      // 입력 수
                 output_names_char.data(), // 출력 노드 이름 배열
@@ -104,4 +96,33 @@ std::vector<std::vector<float>> EmbeddingHelper::runInference(
 
     LOGI("Inference successful. Output shape: [%zu, %zu]", V, D);
     return result;
+}
+
+void EmbeddingHelper::runInference(
+        InferenceBatch& batch,
+        const std::string& outputName
+) {
+    RunTimerLogger timer("runInference (IoBinding)");
+
+    // 1. 세션 유효성 검사
+    if (!ort_session) {
+        LOGE("ONNX session is not initialized. Call initOrtSession() first.");
+        throw std::runtime_error("ONNX session is not initialized.");
+    }
+
+    // 2. 입력 / 출력 바인딩 (배치 버퍼가 그대로면 이전 바인딩 재사용)
+    batch.bind(*ort_session, m_input_names, m_output_names, outputName);
+
+    // 3. 모델 추론 실행 (특징은 이미 입력 버퍼에 기록되어 있음)
+    try {
+        ort_session->Run(Ort::RunOptions{nullptr}, batch.binding());
+    } catch (const Ort::Exception& e) {
+        LOGE("ONNX inference failed: %s", e.what());
+        throw;
+    }
+
+    // 4. 출력 [V, D] 확인 (미리 할당한 출력 버퍼면 복사 없음)
+    batch.collectOutput();
+    const FeatureTensor& output = batch.output();
+    LOGI("Inference successful. Output shape: [%zu, %zu]", output.rows(), output.cols());
 }
\ No newline at end of file
@@ -0,0 +1,160 @@
+//
+// Created by glion on 2025-12-11.
+// IoBinding 기반 추론 배치 구현
+//
+
+#include "onnx/inference_batch.h"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace NdkEssentiaEmbedding;
+
+void InferenceBatch::prepare(size_t V, size_t M, size_t C, size_t T, size_t L) {
+    if (V == m_V && M == m_M && C == m_C && T == m_T && L == m_L && !m_mel.empty() && !m_externalOwner) {
+        return;
+    }
+
+    // 세그먼트 크기가 같고 V 가 기존 용량 이내이면 버퍼는 그대로 두고 바인딩만 다시 생성
+    const bool reuseBuffers = M == m_M && C == m_C && T == m_T && L == m_L && V <= m_capacity;
+
+    m_V = V;
+    m_M = M;
+    m_C = C;
+    m_T = T;
+    m_L = L;
+
+    if (!reuseBuffers) {
+        m_capacity = V;
+        m_mel = FeatureTensor(V * M, T);
+        m_chroma = FeatureTensor(V * C, T);
+        m_tempo = FeatureTensor(V, L);
+    }
+    m_externalOwner.reset();
+    resetBinding();
+}
+
+void InferenceBatch::prepareExternal(
+        size_t V, size_t M, size_t C, size_t T, size_t L,
+        float* mel, float* chroma, float* tempo,
+        std::shared_ptr<const void> owner
+) {
+    m_V = V;
+    m_M = M;
+    m_C = C;
+    m_T = T;
+    m_L = L;
+
+    // 소유 버퍼는 해제하고 다음 prepare 에서 다시 할당
+    m_capacity = 0;
+    m_mel = FeatureTensor::view(mel, V * M, T, T);
+    m_chroma = FeatureTensor::view(chroma, V * C, T, T);
+    m_tempo = FeatureTensor::view(tempo, V, L, L);
+    m_externalOwner = std::move(owner);
+    resetBinding();
+}
+
+void InferenceBatch::resetBinding() {
+    m_output = FeatureTensor();
+
+    // 입력 shape (또는 버퍼) 가 바뀌었으므로 다음 bind 에서 다시 바인딩
+    m_binding.reset();
+    m_inputValues.clear();
+    m_outputValue = Ort::Value(nullptr);
+    m_boundSession = nullptr;
+    m_boundOutput.clear();
+}
+
+FullFeatures InferenceBatch::slot(size_t v) {
+    FullFeatures features;
+    features.mel = FeatureTensor::view(m_mel.row(v * m_M), m_M, m_T, m_T);
+    features.chroma = FeatureTensor::view(m_chroma.row(v * m_C), m_C, m_T, m_T);
+    features.tempo = FeatureTensor::view(m_tempo.row(v), 1, m_L, m_L);
+    return features;
+}
+
+void InferenceBatch::bind(
+        Ort::Session& session,
+        const std::vector<std::string>& inputNames,
+        const std::vector<std::string>& outputNames,
+        const std::string& outputName
+) {
+    if (m_binding && m_boundSession == &session && m_boundOutput == outputName) {
+        return;
+    }
+    if (inputNames.size() != 3) {
+        LOGE("Input tensor count mismatch. Model expects %zu, but 3 are provided.", inputNames.size());
+        throw std::runtime_error("Input tensor count mismatch.");
+    }
+
+    Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(
+            OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
+
+    m_binding = std::make_unique<Ort::IoBinding>(session);
+    m_inputValues.clear();
+
+    const int64_t V = static_cast<int64_t>(m_V);
+
+    // --- 입력: mel [V, M, T], chroma [V, C, T], tempo [V, L] ---
+    const std::vector<int64_t> mel_shape = {V, static_cast<int64_t>(m_M), static_cast<int64_t>(m_T)};
+    const std::vector<int64_t> chr_shape = {V, static_cast<int64_t>(m_C), static_cast<int64_t>(m_T)};
+    const std::vector<int64_t> tmp_shape = {V, static_cast<int64_t>(m_L)};
+
+    m_inputValues.push_back(Ort::Value::CreateTensor<float>(
+            memory_info, m_mel.data(), m_V * m_M * m_T, mel_shape.data(), mel_shape.size()));
+    m_inputValues.push_back(Ort::Value::CreateTensor<float>(
+            memory_info, m_chroma.data(), m_V * m_C * m_T, chr_shape.data(), chr_shape.size()));
+    m_inputValues.push_back(Ort::Value::CreateTensor<float>(
+            memory_info, m_tempo.data(), m_V * m_L, tmp_shape.data(), tmp_shape.size()));
+
+    for (size_t i = 0; i < inputNames.size(); ++i) {
+        m_binding->BindInput(inputNames[i].c_str(), m_inputValues[i]);
+    }
+
+    // --- 출력: [V, D] 의 D 가 고정이면 미리 할당한 버퍼를 바인딩, 동적이면 ORT 가 할당 ---
+    auto it = std::find(outputNames.begin(), outputNames.end(), outputName);
+    if (it == outputNames.end()) {
+        LOGE("Output node '%s' does not exist in the model.", outputName.c_str());
+        throw std::runtime_error("Unknown output node name: " + outputName);
+    }
+    const size_t outputIndex = static_cast<size_t>(it - outputNames.begin());
+    const std::vector<int64_t> out_shape =
+            session.GetOutputTypeInfo(outputIndex).GetTensorTypeAndShapeInfo().GetShape();
+
+    if (out_shape.size() == 2 && out_shape[1] > 0) {
+        const size_t D = static_cast<size_t>(out_shape[1]);
+        const std::vector<int64_t> bound_shape = {V, out_shape[1]};
+        m_output = FeatureTensor(m_V, D);
+        m_outputValue = Ort::Value::CreateTensor<float>(
+                memory_info, m_output.data(), m_V * D, bound_shape.data(), bound_shape.size());
+        m_binding->BindOutput(outputName.c_str(), m_outputValue);
+        m_outputPreallocated = true;
+    } else {
+        m_binding->BindOutput(outputName.c_str(), memory_info);
+        m_outputPreallocated = false;
+    }
+
+    m_boundSession = &session;
+    m_boundOutput = outputName;
+}
+
+void InferenceBatch::collectOutput() {
+    if (m_outputPreallocated) {
+        return; // 바인딩된 출력 버퍼에 이미 기록됨
+    }
+
+    std::vector<Ort::Value> outputs = m_binding->GetOutputValues();
+    if (outputs.empty() || !outputs[0].IsTensor()) {
+        LOGE("Inference returned no valid output tensor.");
+        throw std::runtime_error("Inference returned no valid output tensor.");
+    }
+    m_outputValue = std::move(outputs[0]);
+
+    auto shape = m_outputValue.GetTensorTypeAndShapeInfo().GetShape();
+    if (shape.size() != 2) {
+        LOGE("Output tensor shape is not 2D. Expected [V, D], but got %zu dimensions.", shape.size());
+        throw std::runtime_error("Unexpected output tensor shape.");
+    }
+    const size_t rows = static_cast<size_t>(shape[0]);
+    const size_t D = static_cast<size_t>(shape[1]);
+    m_output = FeatureTensor::view(m_outputValue.GetTensorMutableData<float>(), rows, D, D);
+}
@@ -0,0 +1,81 @@
+//
+// Created by glion on 2025-12-11.
+// IoBinding 기반 추론 배치 - [V,M,T] / [V,C,T] / [V,L] 입력과 [V,D] 출력 버퍼를 1회 할당하여 세션에 바인딩
+// 추출기는 세그먼트 슬롯(입력 버퍼의 뷰)에 직접 기록하고, 후처리는 바인딩된 출력 버퍼에서 제자리 수행
+//
+
+#ifndef NDK_ESSENTIA_TEST_INFERENCE_BATCH_H
+#define NDK_ESSENTIA_TEST_INFERENCE_BATCH_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <onnxruntime_cxx_api.h>
+#include "embedding_helper.h"
+
+namespace NdkEssentiaEmbedding {
+
+    class InferenceBatch {
+    public:
+        InferenceBatch() = default;
+
+        InferenceBatch(const InferenceBatch&) = delete;
+        InferenceBatch& operator=(const InferenceBatch&) = delete;
+
+        // 입력 버퍼 준비. shape 이 이전과 같으면 버퍼와 바인딩을 그대로 재사용
+        // (V 만 줄어든 경우 버퍼는 재사용하고 바인딩만 다시 생성)
+        void prepare(size_t V, size_t M, size_t C, size_t T, size_t L);
+
+        // 외부 입력 버퍼(특징 캐시 매핑 등) [V,M,T] / [V,C,T] / [V,L] 를 복사 없이 그대로 사용
+        // owner 는 다음 prepare / prepareExternal 까지 버퍼를 유지하기 위해 보관
+        void prepareExternal(size_t V, size_t M, size_t C, size_t T, size_t L,
+                             float* mel, float* chroma, float* tempo,
+                             std::shared_ptr<const void> owner);
+
+        size_t batchSize() const { return m_V; }
+
+        // 세그먼트 v 의 특징 슬롯 (입력 버퍼를 가리키는 뷰)
+        FullFeatures slot(size_t v);
+
+        // 세션 입력(mel, chroma, tempo 순)과 출력 outputName 에 버퍼 바인딩 (세션 / shape / 출력 이름이 같으면 생략)
+        void bind(Ort::Session& session,
+                  const std::vector<std::string>& inputNames,
+                  const std::vector<std::string>& outputNames,
+                  const std::string& outputName);
+
+        Ort::IoBinding& binding() { return *m_binding; }
+
+        // Run 이후 출력 [V][D] 갱신 (출력 차원이 동적이라 ORT 가 할당한 경우 그 버퍼를 가리킴)
+        void collectOutput();
+
+        // 추론 결과 [V][D] (복사 없음)
+        FeatureTensor& output() { return m_output; }
+
+    private:
+        // 입력 버퍼가 바뀌었으므로 다음 bind 에서 다시 바인딩
+        void resetBinding();
+
+        size_t m_V = 0;
+        size_t m_M = 0;
+        size_t m_C = 0;
+        size_t m_T = 0;
+        size_t m_L = 0;
+        size_t m_capacity = 0; // 할당된 버퍼가 담을 수 있는 세그먼트 수 (외부 버퍼 사용 중이면 0)
+        std::shared_ptr<const void> m_externalOwner;
+
+        FeatureTensor m_mel;    // [V*M][T]
+        FeatureTensor m_chroma; // [V*C][T]
+        FeatureTensor m_tempo;  // [V][L]
+        FeatureTensor m_output; // [V][D]
+
+        std::unique_ptr<Ort::IoBinding> m_binding;
+        std::vector<Ort::Value> m_inputValues;
+        Ort::Value m_outputValue{nullptr};
+        const Ort::Session* m_boundSession = nullptr;
+        std::string m_boundOutput;
+        bool m_outputPreallocated = false;
+    };
+}
+
+#endif //NDK_ESSENTIA_TEST_INFERENCE_BATCH_H
@@ -10,13 +10,17 @@
 using namespace NdkEssentiaEmbedding;
 
 void EmbeddingHelper::l2Normalize(std::vector<float> &vec) {
+    l2Normalize(vec.data(), vec.size());
+}
+
+void EmbeddingHelper::l2Normalize(float* vec, size_t size) {
     RunTimerLogger timer("l2Normalize");
     const float epsilon = 1e-12f; // 0으로 나누기 방지를 위한 epsilon
 
     // 1. L2 norm (크기) 계산: sqrt(v[0]^2 + v[1]^2 + ...)
     float norm_sq = 0.0f; // norm의 제곱을 먼저 계산
-    for (float val : vec) {
-        norm_sq += val * val;
+    for (size_t i = 0; i < size; ++i) {
+        norm_sq += vec[i] * vec[i];
     }
     float norm = std::sqrt(norm_sq);
 
@@ -24,7 +28,7 @@ void EmbeddingHelper::l2Normalize(std::vector<float> &vec) {
     float inv_norm = 1.0f / (norm + epsilon);
 
     // 3. 벡터를 정규화
-    for (float& val : vec) {
-        val *= inv_norm;
+    for (size_t i = 0; i < size; ++i) {
+        vec[i] *= inv_norm;
     }
 }
\ No newline at end of file
@@ -36,4 +36,35 @@ std::vector<float> EmbeddingHelper::meanPooling(const std::vector<std::vector<fl
     }
 
     return meanEmbedding; // [D] 크기의 평균 벡터 반환
+}
+
+std::vector<float> EmbeddingHelper::meanPooling(const FeatureTensor &embeddings) {
+
+    RunTimerLogger timer("meanPooling");
+
+    if (embeddings.empty()) {
+        LOGW("Cannot perform mean pooling on empty embeddings.");
+        return {};
+    }
+
+    size_t V = embeddings.rows(); // 세그먼트 수 (V)
+    size_t D = embeddings.cols(); // 임베딩 차원 (D)
+
+    std::vector<float> meanEmbedding(D, 0.0f);
+
+    // 1. 모든 행을 합산 (출력 버퍼를 그대로 읽음)
+    for (size_t v = 0; v < V; ++v) {
+        const float* row = embeddings.row(v);
+        for (size_t i = 0; i < D; ++i) {
+            meanEmbedding[i] += row[i];
+        }
+    }
+
+    // 2. 세그먼트 수(V)로 나누어 평균 계산
+    float num_vectors_float = static_cast<float>(V);
+    for (size_t i = 0; i < D; ++i) {
+        meanEmbedding[i] /= num_vectors_float;
+    }
+
+    return meanEmbedding;
 }
\ No newline at end of file
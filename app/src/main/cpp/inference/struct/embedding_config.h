@@ -17,6 +17,15 @@ struct EmbeddingConfig {
     float hop_seconds = 6.4f;
     int segments_per_song = 3;
     bool use_hpss = false;
+    // 세그먼트로 사용될 구간만 seek 하여 디코딩 (전체 디코딩과 동일한 세그먼트를 보장할 수 없으면 자동으로 전체 디코딩)
+    // pre-roll / pts 간격 허용치 / 리샘플러 위상 정렬에 의존하므로 SegmentDecodeJniTest 가 mp3 / m4a 에서 통과하기 전까지 기본 비활성
+    bool segment_only_decode = false;
+    // Chroma 를 LogMel 과 같은 hop / center 패딩 격자에서 계산 (false 이면 기존 hop 512 격자의 앞 T 프레임)
+    bool chroma_at_mel_hop = false;
+    // Tempo onset 을 Essentia melflux 대신 이미 계산된 LogMel 의 양의 차분 평균(librosa onset_strength 방식)으로 계산
+    bool onset_from_logmel = false;
+    // FFmpeg 디코더 스레드 수 (엔진이 스레드 예산으로 설정, 특징 결과에는 영향 없음)
+    int decoder_threads = 1;
 };
 
 #endif //NDK_ESSENTIA_TEST_EMBEDDING_CONFIG_H
@@ -0,0 +1,63 @@
+//
+// Created by glion on 2025-12-02.
+// EmbeddingEngine 동작 옵션 구조체 (특징 추출 설정인 EmbeddingConfig 와 분리)
+//
+
+#ifndef NDK_ESSENTIA_TEST_ENGINE_OPTIONS_H
+#define NDK_ESSENTIA_TEST_ENGINE_OPTIONS_H
+
+#include <string>
+
+struct EngineOptions {
+    // 모델 로드를 백그라운드 스레드에서 시작하고 추론 직전에 join (디코딩/특징 추출 뒤로 로드 시간 은닉)
+    bool async_model_load = true;
+    // 엔진 전체 CPU 스레드 예산 (호출 스레드 포함). 0 이면 코어 수
+    // 배처 사용(max_batch_segments > 0) 이고 예산이 3 이상이면 동시에 진행되는 단계에 나누어 배분
+    //   ORT intra-op 스레드(1/3), FFmpeg 디코더 스레드(1/6), 특징 추출 작업자(나머지, 최대 segments_per_song * 3)
+    // 그 외에는 ORT / 특징 추출이 각각 예산 전체를 쓰고 단계는 차례로 실행 (embedAll 에서도 한 번에 한 단계)
+    int thread_budget = 0;
+    // 최적화된 모델을 모델 옆에 ORT 포맷으로 캐시하여 이후 로드에서 그래프 파싱/최적화 생략
+    bool optimized_model_cache = true;
+    // 모델 / 외부 가중치(model.onnx.data)를 mmap 하여 메모리에서 세션 생성 (가중치를 힙에 중복 적재하지 않음)
+    bool mmap_model = true;
+    // 곡 간 동적 배칭: 여러 곡의 세그먼트를 모아 한 번에 추론할 최대 세그먼트 수 (0 이면 곡마다 개별 추론)
+    int max_batch_segments = 0;
+    // 배치를 채우기 위해 가장 오래된 요청이 기다리는 최대 시간 (특징 추출 중인 다른 곡이 없으면 기다리지 않음)
+    int max_batch_wait_ms = 20;
+    // 임베딩 저장소 사용 - (오디오 내용, 설정, 모델) 이 같은 곡은 파이프라인 없이 저장된 임베딩 반환
+    // (장수 엔진은 호출 측이 결과 재사용을 선택해야 하므로 기본 비활성. 단발성 allInferencePipeline 은 항상 기본 저장소 사용)
+    bool embedding_store = false;
+    // 임베딩 저장소 파일 경로 (비어있으면 <모델 경로>.store). 저장소는 모델 1개 기준 - 열 때 다른 모델의 레코드는 압축으로 제거
+    // (여러 모델을 번갈아 쓰면 모델마다 다른 경로 지정)
+    std::string embedding_store_path;
+    // 세그먼트 특징 캐시 사용 - (오디오 내용, 설정) 이 같은 곡은 디코딩 / 특징 추출 없이 저장된 입력 텐서로 추론
+    // (모델과 무관하므로 모델 교체 후 재인덱싱에 유효. 곡당 float32 약 1.2MB 이므로 기본 비활성)
+    bool feature_cache = false;
+    // 특징 캐시 디렉터리 (비어있으면 모델과 같은 디렉터리의 features)
+    std::string feature_cache_dir;
+    // 특징 캐시를 float16 으로 저장 (디스크 절반, 로드 시 변환 필요 - float32 는 매핑을 그대로 입력으로 바인딩)
+    bool feature_cache_fp16 = false;
+    // 디코딩 PCM 캐시 사용 - 리샘플링된 PCM 을 저장하여 같은 곡은 FFmpeg 디코딩 없이 로드 (미적중 시 전체 디코딩)
+    bool pcm_cache = false;
+    // PCM 캐시 디렉터리 (비어있으면 모델과 같은 디렉터리의 pcm)
+    std::string pcm_cache_dir;
+    // PCM 캐시 디스크 예산 (MB). 넘으면 가장 오래 사용하지 않은 파일부터 삭제
+    int pcm_cache_budget_mb = 1024;
+    // PCM 을 float16 으로 저장 (false 이면 int16)
+    bool pcm_cache_fp16 = false;
+};
+
+// 라이브러리 일괄 인덱싱(embedAll) 파이프라인 설정 - 메모리 사용량은 곡 수가 아니라 큐 깊이 / 단계별 작업자 수로 제한됨
+struct BatchIndexOptions {
+    // 단계 사이 큐 깊이 (디코딩 -> 특징 -> 추론 -> 완료)
+    int queue_depth = 2;
+    // 디코딩 단계 작업자 수 (작업자마다 엔진 예산의 디코딩 몫 사용. 배처 없는 엔진에서는 다른 단계와 차례로 실행)
+    int decode_workers = 1;
+    // 특징 추출 단계 작업자 수 (곡 내부 병렬 처리는 엔진의 work-stealing 작업자 풀 공유
+    // 작업자도 호출 스레드로 풀 작업에 참여하므로 1을 넘는 만큼 예산의 특징 추출 몫에 더해짐)
+    int feature_workers = 2;
+    // 추론 단계 작업자 수 (동시에 배처에 제출할 수 있는 곡 수. 배처 결과를 기다리기만 하므로 예산에 포함되지 않음)
+    int inference_workers = 2;
+};
+
+#endif //NDK_ESSENTIA_TEST_ENGINE_OPTIONS_H
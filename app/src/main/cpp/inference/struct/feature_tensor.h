@@ -0,0 +1,128 @@
+//
+// Created by glion on 2025-12-10.
+// 세그먼트 특징 텐서 (LogMel [M][T], Chroma [C][T], Tempo [1][L])
+// 특징마다 정렬된 연속 버퍼 1개 + 명시적 행 간격(stride). 자체 버퍼 소유 또는 외부 버퍼(배치 텐서 등)의 뷰
+//
+
+#ifndef NDK_ESSENTIA_TEST_FEATURE_TENSOR_H
+#define NDK_ESSENTIA_TEST_FEATURE_TENSOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+class FeatureTensor {
+public:
+    // 소유 버퍼 정렬 (캐시 라인 / SIMD 로드 기준)
+    static constexpr size_t ALIGNMENT = 64;
+
+    FeatureTensor() = default;
+
+    // [rows][cols] 소유 버퍼 할당 (0 초기화, stride == cols)
+    FeatureTensor(size_t rows, size_t cols) : m_rows(rows), m_cols(cols), m_stride(cols) {
+        const size_t count = rows * cols;
+        if (count == 0) return;
+        void* ptr = nullptr;
+        if (posix_memalign(&ptr, ALIGNMENT, count * sizeof(float)) != 0) {
+            throw std::bad_alloc();
+        }
+        m_storage.reset(static_cast<float*>(ptr));
+        m_data = m_storage.get();
+        std::memset(m_data, 0, count * sizeof(float));
+    }
+
+    // 외부 버퍼 [rows][cols] 뷰 (행 간격 stride, 원소 단위). 버퍼는 뷰보다 오래 살아있어야 함
+    static FeatureTensor view(float* data, size_t rows, size_t cols, size_t stride) {
+        FeatureTensor tensor;
+        tensor.m_data = data;
+        tensor.m_rows = rows;
+        tensor.m_cols = cols;
+        tensor.m_stride = stride;
+        return tensor;
+    }
+
+    FeatureTensor(FeatureTensor&& other) noexcept { *this = std::move(other); }
+
+    FeatureTensor& operator=(FeatureTensor&& other) noexcept {
+        if (this != &other) {
+            m_storage = std::move(other.m_storage);
+            m_data = other.m_data;
+            m_rows = other.m_rows;
+            m_cols = other.m_cols;
+            m_stride = other.m_stride;
+            other.m_data = nullptr;
+            other.m_rows = other.m_cols = other.m_stride = 0;
+        }
+        return *this;
+    }
+
+    FeatureTensor(const FeatureTensor&) = delete;
+    FeatureTensor& operator=(const FeatureTensor&) = delete;
+
+    size_t rows() const { return m_rows; }
+    size_t cols() const { return m_cols; }
+    size_t stride() const { return m_stride; }
+    bool empty() const { return m_rows == 0 || m_cols == 0; }
+    bool isView() const { return m_data != nullptr && !m_storage; }
+    bool isContiguous() const { return m_stride == m_cols; }
+
+    float* data() { return m_data; }
+    const float* data() const { return m_data; }
+    float* row(size_t r) { return m_data + r * m_stride; }
+    const float* row(size_t r) const { return m_data + r * m_stride; }
+    float& operator()(size_t r, size_t c) { return m_data[r * m_stride + c]; }
+    float operator()(size_t r, size_t c) const { return m_data[r * m_stride + c]; }
+
+    // 비어있으면 [rows][cols] 소유 버퍼 할당, 이미 준비된 텐서(뷰 포함)면 shape 일치 확인 (불일치 시 예외)
+    void ensureShape(size_t rows, size_t cols) {
+        if (m_data == nullptr && m_rows == 0) {
+            *this = FeatureTensor(rows, cols);
+            return;
+        }
+        if (m_rows != rows || m_cols != cols) {
+            throw std::invalid_argument("FeatureTensor shape mismatch : expected [" + std::to_string(rows) + "][" +
+                                        std::to_string(cols) + "], got [" + std::to_string(m_rows) + "][" +
+                                        std::to_string(m_cols) + "]");
+        }
+    }
+
+    // [dstRows][dstCols] 연속 버퍼로 복사. 범위를 벗어나는 부분은 버리고 모자란 부분은 0 으로 채움
+    void copyTo(float* dst, size_t dstRows, size_t dstCols) const {
+        if (dst == m_data && dstCols == m_stride && dstRows == m_rows && dstCols == m_cols) {
+            return; // 이미 대상 버퍼를 가리키는 뷰
+        }
+        const size_t rows = std::min(m_rows, dstRows);
+        const size_t cols = std::min(m_cols, dstCols);
+        if (rows == m_rows && rows == dstRows && cols == dstCols && isContiguous() && cols == m_cols) {
+            std::memcpy(dst, m_data, rows * cols * sizeof(float));
+            return;
+        }
+        for (size_t r = 0; r < dstRows; ++r) {
+            float* out = dst + r * dstCols;
+            size_t copied = 0;
+            if (r < rows) {
+                std::memcpy(out, row(r), cols * sizeof(float));
+                copied = cols;
+            }
+            std::fill(out + copied, out + dstCols, 0.0f);
+        }
+    }
+
+private:
+    struct FreeDeleter {
+        void operator()(float* ptr) const { std::free(ptr); }
+    };
+
+    std::unique_ptr<float, FreeDeleter> m_storage;
+    float* m_data = nullptr;
+    size_t m_rows = 0;
+    size_t m_cols = 0;
+    size_t m_stride = 0;
+};
+
+#endif //NDK_ESSENTIA_TEST_FEATURE_TENSOR_H
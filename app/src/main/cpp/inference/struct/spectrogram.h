@@ -0,0 +1,37 @@
+//
+// Created by glion on 2025-12-05.
+// 한 세그먼트의 STFT 결과 (LogMel / Tempo 가 공유하는 스펙트럼 프론트엔드 출력)
+//
+
+#ifndef NDK_ESSENTIA_TEST_SPECTROGRAM_H
+#define NDK_ESSENTIA_TEST_SPECTROGRAM_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "struct/embedding_config.h"
+
+// LogMel / Tempo 공통 STFT 크기 (Librosa 기본 n_fft)
+constexpr int STFT_N_FFT = 2048;
+
+// LogMel / Tempo STFT hop (샘플). Python 의 int() (절삭)와 일치시키기 위해 static_cast<int> 사용
+inline int melHopLength(const EmbeddingConfig& config) {
+    return std::max(1, static_cast<int>(config.sr * config.mel_hop_ms / 1000.0f));
+}
+
+/**
+ * 파워 스펙트럼 [T][F] (row-major, 프레임 t 의 F 개 bin 이 연속)
+ * n_fft = 2048, hop = mel_hop_ms, Hann 윈도우, Librosa 'center=True' 패딩 기준
+ */
+struct Spectrogram {
+    size_t numFrames = 0; // T
+    size_t numBins = 0;   // F (= n_fft / 2 + 1)
+    std::vector<float> power;
+
+    const float* frame(size_t t) const { return power.data() + t * numBins; }
+    float* frame(size_t t) { return power.data() + t * numBins; }
+    bool empty() const { return numFrames == 0; }
+};
+
+#endif //NDK_ESSENTIA_TEST_SPECTROGRAM_H
@@ -0,0 +1,115 @@
+//
+// Created by glion on 2025-12-08.
+// temp : 테스트용 - 기존 Essentia STFT 체인과 StftEngine 성능/정확도 비교
+//
+#include "embedding_helper.h"
+#include "feature/stft_engine.h"
+#include <essentia.h>
+#include <algorithmfactory.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+using namespace NdkEssentiaEmbedding;
+using namespace essentia;
+using namespace essentia::standard;
+
+namespace {
+    // 기존 구현: 패딩 복사 + FrameCutter -> Windowing -> PowerSpectrum (프레임마다 알고리즘 호출)
+    Spectrogram legacyEssentiaStft(AudioView audio, int n_fft, int hopLength) {
+        const int pad_width = n_fft / 2;
+        std::vector<Real> padded_audio(pad_width, 0.0f);
+        padded_audio.insert(padded_audio.end(), audio.begin(), audio.end());
+        padded_audio.resize(padded_audio.size() + pad_width, 0.0f);
+
+        AlgorithmFactory &factory = AlgorithmFactory::instance();
+        std::unique_ptr<Algorithm> frameCutter(factory.create("FrameCutter",
+                                                              "frameSize", n_fft,
+                                                              "hopSize", hopLength,
+                                                              "lastFrameToEndOfFile", false,
+                                                              "startFromZero", true
+        ));
+        std::unique_ptr<Algorithm> windowing(factory.create("Windowing",
+                                                            "type", "hann",
+                                                            "size", n_fft
+        ));
+        std::unique_ptr<Algorithm> spectrum(factory.create("PowerSpectrum"));
+
+        Spectrogram stft;
+        stft.numBins = n_fft / 2 + 1;
+        stft.power.reserve((padded_audio.size() / hopLength + 1) * stft.numBins);
+
+        std::vector<Real> frame, windowedFrame, spec;
+        frameCutter->input("signal").set(padded_audio);
+        frameCutter->output("frame").set(frame);
+        windowing->input("frame").set(frame);
+        windowing->output("frame").set(windowedFrame);
+        spectrum->input("signal").set(windowedFrame);
+        spectrum->output("powerSpectrum").set(spec);
+
+        while (true) {
+            frameCutter->compute();
+            if (frame.empty()) {
+                break;
+            }
+            windowing->compute();
+            spectrum->compute();
+            stft.power.insert(stft.power.end(), spec.begin(), spec.end());
+            stft.numFrames++;
+        }
+        return stft;
+    }
+
+    template <typename Fn>
+    double averageMs(int repeat, Fn&& fn) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < repeat; ++i) fn();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count() / repeat;
+    }
+}
+
+std::vector<float> EmbeddingHelper::benchmarkStft(
+        AudioView segment,
+        const EmbeddingConfig &config,
+        int repeat
+) {
+    RunTimerLogger timer("benchmarkStft");
+
+    repeat = std::max(1, repeat);
+    const int n_fft = STFT_N_FFT;
+    const int hopLength = melHopLength(config);
+
+    Spectrogram legacy;
+    Spectrogram fused;
+    double legacyMs = averageMs(repeat, [&]() { legacy = legacyEssentiaStft(segment, n_fft, hopLength); });
+    double fusedMs = averageMs(repeat, [&]() { fused = computeStft(segment, config); });
+
+    // 정확도: 프레임별 최대 파워 대비 최대 절대 오차 (무음 프레임은 Essentia 가 노이즈를 더하므로 제외)
+    float maxRelDiff = 0.0f;
+    if (legacy.numFrames == fused.numFrames && legacy.numBins == fused.numBins) {
+        for (size_t t = 0; t < fused.numFrames; ++t) {
+            const float* a = legacy.frame(t);
+            const float* b = fused.frame(t);
+            float peak = *std::max_element(b, b + fused.numBins);
+            if (peak <= 0.0f) continue;
+            for (size_t f = 0; f < fused.numBins; ++f) {
+                maxRelDiff = std::max(maxRelDiff, std::fabs(a[f] - b[f]) / peak);
+            }
+        }
+    } else {
+        maxRelDiff = INFINITY;
+    }
+
+    LOGI("benchmarkStft: samples=%zu, legacy=%.3fms, fused=%.3fms (x%.2f), frames=%zu/%zu, maxRelDiff=%g",
+         segment.size(), legacyMs, fusedMs, fusedMs > 0.0 ? legacyMs / fusedMs : 0.0,
+         legacy.numFrames, fused.numFrames, maxRelDiff);
+
+    return {
+            static_cast<float>(legacyMs),
+            static_cast<float>(fusedMs),
+            static_cast<float>(legacy.numFrames),
+            static_cast<float>(fused.numFrames),
+            maxRelDiff
+    };
+}
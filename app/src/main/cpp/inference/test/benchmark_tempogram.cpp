@@ -0,0 +1,108 @@
+//
+// Created by glion on 2025-12-09.
+// temp : 테스트용 - 기존 FrameCutter + AutoCorrelation 템포그램과 meanTempogram 성능/정확도 비교
+//
+#include "embedding_helper.h"
+#include <essentia.h>
+#include <algorithmfactory.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+using namespace NdkEssentiaEmbedding;
+using namespace essentia;
+using namespace essentia::standard;
+
+namespace {
+    // 기존 구현: hop 1 윈도우마다 AutoCorrelation -> 2D 템포그램 -> 시간 평균 -> 앞 numLags 개
+    std::vector<float> legacyMeanTempogram(const std::vector<float>& onset, int winLength, int numLags) {
+        AlgorithmFactory &factory = AlgorithmFactory::instance();
+        std::unique_ptr<Algorithm> tempoFrameCutter(
+                factory.create("FrameCutter",
+                               "frameSize", winLength,
+                               "hopSize", 1,
+                               "lastFrameToEndOfFile", false,
+                               "startFromZero", true
+                ));
+        std::unique_ptr<Algorithm> autoCorrelationAlgo(factory.create("AutoCorrelation"));
+
+        std::vector<Real> onset_frame, autocorr_vec;
+        std::vector<std::vector<Real>> tempogram2D;
+        tempogram2D.reserve(onset.size() + 1);
+
+        tempoFrameCutter->input("signal").set(onset);
+        tempoFrameCutter->output("frame").set(onset_frame);
+        autoCorrelationAlgo->input("array").set(onset_frame);
+        autoCorrelationAlgo->output("autoCorrelation").set(autocorr_vec);
+
+        while (true) {
+            tempoFrameCutter->compute();
+            if (onset_frame.empty()) {
+                break;
+            }
+            autoCorrelationAlgo->compute();
+            tempogram2D.push_back(autocorr_vec);
+        }
+
+        std::vector<float> histogram(winLength, 0.0f);
+        size_t num_frames = tempogram2D.size();
+        if (num_frames > 0) {
+            for (size_t t = 0; t < num_frames; ++t) {
+                if (tempogram2D[t].size() == static_cast<size_t>(winLength)) {
+                    for (int l = 0; l < winLength; ++l) {
+                        histogram[l] += tempogram2D[t][l];
+                    }
+                }
+            }
+            for (int l = 0; l < winLength; ++l) {
+                histogram[l] /= num_frames;
+            }
+        }
+        histogram.resize(numLags, 0.0f);
+        return histogram;
+    }
+
+    template <typename Fn>
+    double averageMs(int repeat, Fn&& fn) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < repeat; ++i) fn();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count() / repeat;
+    }
+}
+
+std::vector<float> EmbeddingHelper::benchmarkTempogram(
+        AudioView segment,
+        const EmbeddingConfig &config,
+        int repeat
+) {
+    RunTimerLogger timer("benchmarkTempogram");
+
+    repeat = std::max(1, repeat);
+    const int winLength = 384; // Librosa 'tempogram' 기본 win_length
+    const std::vector<float> onset = computeOnsetEnvelope(computeStft(segment, config), config);
+
+    std::vector<float> legacy;
+    std::vector<float> fast;
+    double legacyMs = averageMs(repeat, [&]() { legacy = legacyMeanTempogram(onset, winLength, config.tempo_win); });
+    double fastMs = averageMs(repeat, [&]() { fast = meanTempogram(onset, winLength, config.tempo_win); });
+
+    // 정확도: lag 별 최대 상대 오차 (lag 0 의 값 기준)
+    float maxRelDiff = 0.0f;
+    const float scale = std::max(1e-12f, std::fabs(legacy.empty() ? 0.0f : legacy[0]));
+    for (size_t l = 0; l < legacy.size() && l < fast.size(); ++l) {
+        maxRelDiff = std::max(maxRelDiff, std::fabs(legacy[l] - fast[l]) / scale);
+    }
+    if (legacy.size() != fast.size()) {
+        maxRelDiff = INFINITY;
+    }
+
+    LOGI("benchmarkTempogram: onsetFrames=%zu, legacy=%.3fms, fast=%.3fms (x%.2f), maxRelDiff=%g",
+         onset.size(), legacyMs, fastMs, fastMs > 0.0 ? legacyMs / fastMs : 0.0, maxRelDiff);
+
+    return {
+            static_cast<float>(legacyMs),
+            static_cast<float>(fastMs),
+            maxRelDiff
+    };
+}
@@ -0,0 +1,47 @@
+//
+// Created by glion on 2025-12-14.
+// temp : 테스트 - 스레드 예산(1 ~ N 코어) 별 전체 embed 소요시간 측정
+//
+
+#include "engine/embedding_engine.h"
+#include <algorithm>
+#include <chrono>
+
+using namespace NdkEssentiaEmbedding;
+
+std::vector<float> EmbeddingEngine::benchmarkThreadBudget(
+        const std::string& modelPath,
+        const std::string& filePath,
+        int maxBudget,
+        int repeat
+) {
+    using Clock = std::chrono::steady_clock;
+
+    maxBudget = WorkerPool::resolveThreadCount(maxBudget);
+    repeat = std::max(1, repeat);
+
+    std::vector<float> result;
+    result.reserve(maxBudget);
+
+    for (int budget = 1; budget <= maxBudget; ++budget) {
+        EngineOptions options;
+        options.thread_budget = budget;
+        options.async_model_load = false; // 모델 로드 시간은 측정에서 제외
+        options.embedding_store = false;  // 저장소 적중 없이 매번 전체 파이프라인 측정
+
+        EmbeddingEngine engine(modelPath, EmbeddingConfig(), options);
+        engine.embed(filePath); // 워밍업 (버퍼 할당, ORT 스레드 생성, 페이지 캐시)
+
+        auto start = Clock::now();
+        for (int r = 0; r < repeat; ++r) {
+            engine.embed(filePath);
+        }
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / repeat;
+
+        LOGI("benchmarkThreadBudget :: budget %d -> %.3f ms (ort intra-op %d, feature %d, ort threads %d)",
+             budget, ms, engine.m_executor.inferenceThreads(), engine.m_executor.featureThreads(),
+             engine.m_executor.ortThreadCount());
+        result.push_back(static_cast<float>(ms));
+    }
+    return result;
+}
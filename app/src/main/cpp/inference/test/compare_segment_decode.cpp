@@ -0,0 +1,60 @@
+//
+// Created by glion on 2025-12-23.
+// temp : 테스트용 - 구간 디코딩 세그먼트와 전체 디코딩 + segmenter 세그먼트 샘플 단위 비교
+//
+#include "embedding_helper.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace NdkEssentiaEmbedding;
+
+namespace {
+    // 같은 샘플로 볼 수 있는 최대 절대 오차 (디코더 / 리샘플러가 결정적이면 0, 위치가 어긋나면 이보다 훨씬 큼)
+    constexpr float SAMPLE_TOLERANCE = 1e-4f;
+}
+
+std::vector<float> EmbeddingHelper::compareSegmentDecode(
+        const AudioSource& source,
+        const EmbeddingConfig& config
+) {
+    // 1. 구간 디코딩 (전체 디코딩으로 대체하지 않음 - 계획이 거절되면 planned = 0)
+    SegmentedAudio planned;
+    const bool plannedOk = loadPlannedSegments(source, config, planned);
+
+    // 2. 전체 디코딩 + segmenter (기준)
+    AudioData full = loadAudioFile(source, config);
+    const std::vector<AudioView> reference = segmenter(full, config);
+
+    // 3. 세그먼트별 샘플 비교 (길이가 다르면 짧은 쪽까지 비교하고 나머지는 불일치로 집계)
+    size_t compared = 0;
+    size_t mismatched = 0;
+    float maxAbsDiff = 0.0f;
+    if (plannedOk) {
+        const size_t count = std::min(planned.size(), reference.size());
+        for (size_t s = 0; s < count; ++s) {
+            const AudioView& a = planned.segments[s];
+            const AudioView& b = reference[s];
+            const size_t n = std::min(a.size(), b.size());
+            for (size_t i = 0; i < n; ++i) {
+                const float diff = std::fabs(a[i] - b[i]);
+                maxAbsDiff = std::max(maxAbsDiff, diff);
+                if (diff > SAMPLE_TOLERANCE) ++mismatched;
+            }
+            compared += n;
+            mismatched += std::max(a.size(), b.size()) - n;
+        }
+        LOGI("compareSegmentDecode :: %zu / %zu segments, %zu samples, %zu mismatched, max diff %g",
+             planned.size(), reference.size(), compared, mismatched, maxAbsDiff);
+    } else {
+        LOGW("compareSegmentDecode :: segment plan declined : %s", source.describe().c_str());
+    }
+
+    return {
+            plannedOk ? 1.0f : 0.0f,
+            static_cast<float>(planned.size()),
+            static_cast<float>(reference.size()),
+            static_cast<float>(compared),
+            static_cast<float>(mismatched),
+            maxAbsDiff
+    };
+}
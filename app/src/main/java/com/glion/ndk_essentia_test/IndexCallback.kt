@@ -0,0 +1,22 @@
+package com.glion.ndk_essentia_test
+
+/**
+ * Project : ndk-test
+ * File : IndexCallback
+ * Created by glion on 2025-12-16
+ *
+ * Description:
+ * - 라이브러리 일괄 인덱싱(indexLibrary) 곡 단위 완료 콜백
+ * - indexLibrary 를 호출한 스레드에서 완료 순서대로 호출됨
+ *
+ * Copyright @2025 Gangglion. All rights reserved
+ */
+fun interface IndexCallback {
+    /**
+     * @param index 입력 경로 배열 내 위치
+     * @param path 오디오 파일 경로
+     * @param embedding 최종 임베딩 (실패 시 null)
+     * @param error 실패 사유 (성공 시 null)
+     */
+    fun onIndexed(index: Int, path: String, embedding: FloatArray?, error: String?)
+}
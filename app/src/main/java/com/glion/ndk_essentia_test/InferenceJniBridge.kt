@@ -20,15 +20,129 @@ class InferenceJniBridge {
 
     /**
      * 최종 임베딩 구하는 모든 파이프라인
+     * - 임베딩 저장소(<modelPath>.store)에 같은 곡 / 설정 / 모델의 결과가 있으면 모델 로드 없이 바로 반환, 없으면 계산 후 저장
      * @param path 오디오파일 경로
      * @param modelPath 모델 파일 경로
      */
     external fun allInferencePipeline(path: String, modelPath: String) : FloatArray?
 
+    /**
+     * 최종 임베딩 구하는 모든 파이프라인 - 파일 디스크립터 구간 입력 (임시 파일 복사 없이 그 자리에서 디코딩, 저장소 사용은 [allInferencePipeline] 과 같음)
+     * @param fd 파일 디스크립터 (호출이 끝날 때까지 열려 있어야 함, 예: AssetFileDescriptor.parcelFileDescriptor.fd)
+     * @param offset 오디오 데이터 시작 위치 (예: AssetFileDescriptor.startOffset)
+     * @param length 오디오 데이터 길이 (음수이면 파일 끝까지)
+     * @param modelPath 모델 파일 경로
+     */
+    external fun allInferencePipelineFd(fd: Int, offset: Long, length: Long, modelPath: String) : FloatArray?
+
+    /**
+     * 네이티브 임베딩 엔진 생성 - 모델 로드 및 Essentia 초기화를 1회만 수행
+     * @param modelPath 모델 파일 경로
+     * @return 엔진 핸들. 사용이 끝나면 반드시 [destroyEngine] 호출
+     */
+    external fun createEngine(modelPath: String) : Long
+
+    /**
+     * 특징 캐시를 사용하는 네이티브 임베딩 엔진 생성
+     * - 곡마다 세그먼트 특징(모델 입력 텐서)을 cacheDir 에 저장하고, 이후 같은 곡은 디코딩 / 특징 추출 없이 추론만 수행
+     * - 캐시는 모델과 무관하므로 모델 교체 후 재인덱싱에도 재사용됨
+     * @param modelPath 모델 파일 경로
+     * @param cacheDir 특징 캐시 디렉터리 (없으면 생성)
+     * @param halfPrecision true 이면 float16 으로 저장 (디스크 절반, 값은 반정밀도로 반올림)
+     * @return 엔진 핸들. 사용이 끝나면 반드시 [destroyEngine] 호출
+     */
+    external fun createEngineWithFeatureCache(modelPath: String, cacheDir: String, halfPrecision: Boolean) : Long
+
+    /**
+     * 임베딩 저장소를 사용하는 네이티브 임베딩 엔진 생성
+     * - (오디오 내용, 설정, 모델) 이 같은 곡은 디코딩 / 특징 추출 / 추론 없이 저장된 임베딩 반환
+     * - [createEngine] 으로 만든 엔진은 저장소를 사용하지 않음 (항상 전체 파이프라인 수행)
+     * @param modelPath 모델 파일 경로
+     * @param storePath 저장소 파일 경로 (빈 문자열이면 <modelPath>.store)
+     * @return 엔진 핸들. 사용이 끝나면 반드시 [destroyEngine] 호출
+     */
+    external fun createEngineWithStore(modelPath: String, storePath: String) : Long
+
+    /**
+     * 엔진 핸들을 사용한 최종 임베딩 추출 (모델 재로드 없음)
+     * @param handle [createEngine] 으로 얻은 엔진 핸들
+     * @param path 오디오파일 경로
+     */
+    external fun embedWithEngine(handle: Long, path: String) : FloatArray?
+
+    /**
+     * 엔진 핸들을 사용한 최종 임베딩 추출 - 파일 디스크립터 구간 입력
+     * @param handle [createEngine] 으로 얻은 엔진 핸들
+     * @param fd 파일 디스크립터 (호출이 끝날 때까지 열려 있어야 함)
+     * @param offset 오디오 데이터 시작 위치
+     * @param length 오디오 데이터 길이 (음수이면 파일 끝까지)
+     */
+    external fun embedWithEngineFd(handle: Long, fd: Int, offset: Long, length: Long) : FloatArray?
+
+    /**
+     * 엔진 핸들을 사용한 최종 임베딩 추출 - 메모리 입력 (다운로드한 바이트 등, 복사 없이 디코딩)
+     * @param handle [createEngine] 으로 얻은 엔진 핸들
+     * @param buffer direct ByteBuffer ([java.nio.ByteBuffer.allocateDirect])
+     * @param position 오디오 데이터 시작 위치
+     * @param limit 오디오 데이터 끝 위치 (미포함)
+     */
+    external fun embedWithEngineBuffer(handle: Long, buffer: java.nio.ByteBuffer, position: Int, limit: Int) : FloatArray?
+
+    /**
+     * 네이티브 임베딩 엔진 해제
+     * @param handle [createEngine] 으로 얻은 엔진 핸들
+     */
+    external fun destroyEngine(handle: Long)
+
+    /**
+     * 엔진 핸들을 사용한 라이브러리 일괄 인덱싱 (디코딩 / 특징 추출 / 추론 단계를 겹쳐 수행, 곡 간 배치 추론)
+     * @param handle [createEngine] 으로 얻은 엔진 핸들
+     * @param paths 오디오 파일 경로 목록
+     * @param callback 곡마다 완료 순서대로 호출 (이 함수를 호출한 스레드에서 수행)
+     * @return 성공한 곡 수
+     */
+    external fun indexLibrary(handle: Long, paths: Array<String>, callback: IndexCallback) : Int
+
+    /**
+     * temp : 테스트 - 엔진 생성 이후 저장소 / 특징 캐시 적중 횟수
+     * @param handle 엔진 핸들
+     * @return [저장소 적중(파일 내용), 저장소 적중(디코딩 지문), 특징 캐시 적중, 저장소 레코드 수]
+     */
+    external fun getCacheStats(handle: Long) : LongArray?
+
     /**
      * temp : 테스트 - 특정 특징 추출하여 코사인 유사도 비교용
      * @param path 오디오 파일 경로
      * @param type 특징 타입(L : LogMel, C : Chroma, T : Tempo)
      */
     external fun getFlattenFeature(path: String, type: String) : FloatArray?
-}
\ No newline at end of file
+
+    /**
+     * temp : 테스트 - 기존 Essentia STFT 체인과 StftEngine 비교 (첫 세그먼트 기준)
+     * @param path 오디오 파일 경로
+     * @return [legacyMs, fusedMs, legacyFrames, fusedFrames, maxRelDiff]
+     */
+    external fun benchmarkStft(path: String) : FloatArray?
+
+    /**
+     * temp : 테스트 - 기존 2D 템포그램 평균과 meanTempogram 비교 (첫 세그먼트 기준)
+     * @param path 오디오 파일 경로
+     * @return [legacyMs, fastMs, maxRelDiff]
+     */
+    external fun benchmarkTempogram(path: String) : FloatArray?
+
+    /**
+     * temp : 테스트 - 구간 디코딩(segment_only_decode) 세그먼트와 전체 디코딩 + segmenter 세그먼트 샘플 단위 비교
+     * @param path 오디오 파일 경로
+     * @return [planned(1/0), plannedSegments, fullSegments, comparedSamples, mismatchedSamples, maxAbsDiff]
+     */
+    external fun compareSegmentDecode(path: String) : FloatArray?
+
+    /**
+     * temp : 테스트 - 엔진 스레드 예산(1 ~ 코어 수) 별 embed 평균 소요시간
+     * @param path 오디오 파일 경로
+     * @param modelPath 모델 파일 경로
+     * @return [budget=1 ms, budget=2 ms, ...]
+     */
+    external fun benchmarkThreadBudget(path: String, modelPath: String) : FloatArray?
+}
@@ -15,6 +15,10 @@ class MainActivity : AppCompatActivity() {
     private lateinit var binding: ActivityMainBinding
     private lateinit var mContext: Context
 
+    private val jni = InferenceJniBridge()
+    // 네이티브 엔진 핸들 (최초 추론 시 생성, 액티비티 종료 시 해제)
+    private var engineHandle = 0L
+
     override fun onCreate(savedInstanceState: Bundle?) {
         super.onCreate(savedInstanceState)
 
@@ -22,24 +26,34 @@ class MainActivity : AppCompatActivity() {
         setContentView(binding.root)
         mContext = this
 
-        val jni = InferenceJniBridge()
-
         binding.btnStart.setOnClickListener {
-            // 오디오 파일 읽기
-            val audioSamplePath = getPathFromAssets("sample.mp3")
-
-            // 모델 읽기
-            val modelPath = getPathFromAssets("model.onnx")
-            getPathFromAssets("model.onnx.data")
+            // 모델 읽기 및 엔진 생성 (최초 1회)
+            // (모델은 외부 가중치 파일 model.onnx.data 를 경로로 찾으므로 파일로 복사)
+            if (engineHandle == 0L) {
+                val modelPath = getPathFromAssets("model.onnx")
+                getPathFromAssets("model.onnx.data")
+                engineHandle = jni.createEngine(modelPath)
+            }
 
             val elapsed = measureNanoTime  {
-                val embedding = jni.allInferencePipeline(audioSamplePath, modelPath)!!
+                // 오디오는 APK 에셋을 복사 없이 fd 구간으로 바로 디코딩 (압축되지 않은 에셋만 openFd 가능)
+                val embedding = mContext.assets.openFd("sample.mp3").use { afd ->
+                    jni.embedWithEngineFd(engineHandle, afd.parcelFileDescriptor.fd, afd.startOffset, afd.length)!!
+                }
                 if(embedding.isEmpty()) Log.e("glion", "임베딩 얻기 실패. 사이즈가 0")
             }
             Log.d("glion", "총 소요시간 :: ${elapsed / 1_000_000} ms")
         }
     }
 
+    override fun onDestroy() {
+        if (engineHandle != 0L) {
+            jni.destroyEngine(engineHandle)
+            engineHandle = 0L
+        }
+        super.onDestroy()
+    }
+
     private fun getPathFromAssets(assetName: String): String {
         val file = File(mContext.filesDir, assetName)
         if (!file.exists()) {